@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+# Generates random scene files, e.g. to benchmark the parser (2d_physics --parser-benchmark) or the simulation.
+# Same arguments -> same file.
+#
+# Usage: generate.py <objects> [--broadphase <name>] [--time <ticks>] [--seed <n>] > scene.json
+#
+# Parser benchmark scene (58 MB, 300k objects):
+#   python3 scenes/generate.py 300000 --broadphase grid --time 0 --seed 3 > huge.json
+#   2d_physics --parser-benchmark huge.json
+
+import argparse
+import random
+
+
+def main():
+  parser = argparse.ArgumentParser(description = "Generates a random scene file on stdout.")
+  parser.add_argument("objects", type = int, help = "number of objects")
+  parser.add_argument("--broadphase", help = "brute-force, grid, sweep-prune or aabb-tree (default: none given)")
+  parser.add_argument("--time", type = int, default = 100, help = "ticks, objects spawn in the first half (default: 100)")
+  parser.add_argument("--seed", type = int, default = 1)
+  args = parser.parse_args()
+  
+  random.seed(args.seed)
+  extent = 18 * args.objects ** 0.5   # about the same density for any count
+  
+  print('{\n  "scene": "Gen",\n  "background": [0.0f, 0.0f, 0.0f],\n  "time": %d,' % args.time)
+  if args.broadphase:
+    print('  "broadphase": "%s",' % args.broadphase)
+  print('  "objects":\n    [')
+  
+  objects = []
+  for i in range(args.objects):
+    type = random.choice(["triangle", "rectangle", "circle"])
+    objects.append(
+      '      "%s":\n'
+      '        {\n'
+      '          "position": [%.1ff, %.1ff],\n'
+      '          "rotation": %.1ff,\n'
+      '          "size": %.1ff,\n'
+      '          "color": [1.0f, 0.0f, 0.0f],\n'
+      '          "time": %d\n'
+      '        }' % (
+        type,
+        random.uniform(0, extent),
+        random.uniform(0, extent),
+        random.uniform(0, 360),
+        random.uniform(10, 30),
+        random.randint(0, args.time // 2)
+      )
+    )
+  print(',\n'.join(objects))
+  print('    ]\n}')
+
+
+main()
@@ -27,6 +27,16 @@ SOFTWARE.
 #include "app.h"
 
 #include <iostream>
+#include <sstream>
+#include <exception>
+#include <stdexcept>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+#include "thread_pool.h"
+#include "trajectory.h"
+#include "sat_kernel.h"
 
 
 
@@ -43,17 +53,241 @@ void App::print_help(){
     << "\n"
     << "Options:\n"
     << "  -h, --help: Displays this message.\n"
+    << "  -H, --headless: Simulates without opening a window (no graphics at all).\n"
+    << "  -t, --threads <n>: Number of threads for collision detection and for parsing large scene files (default: 1).\n"
+    << "  -r, --tick-rate <n>: Physics ticks per second (default: 100).\n"
+    << "  -f, --frame-rate <n>: Frames per second, drawn in between ticks (default: 60).\n"
+    << "  -s, --speed <x>: Real-time factor, e.g. 4 or 0.25 (default: 1).\n"
+    << "  -b, --batch: Runs ticks back to back as fast as possible, ignoring '--speed'.\n"
+    << "  -i, --iterations <n>: Contact solver iterations per tick, more give stiffer stacks (default: 10).\n"
+    << "  -c, --contacts: Shows the contact points of the current tick as an overlay.\n"
+    << "  -C, --convert: Converts every given scene file into the binary scene format (same name, extension '.bin') instead of running it. "
+    << "Binary scene files are recognised automatically when loading.\n"
+    << "  -S, --stream: Reads objects while the scene runs, shortly before they spawn, instead of all at once up front. "
+    << "Needs objects ordered by 'time' (binary scene files always are).\n"
+    << "  -k, --cache <dir>: Keeps every scene file compiled (parsed & prepared) in <dir>, keyed by its content. "
+    << "Later runs of the same content load the compiled scene instead, not with '--stream'.\n"
+    << "  -p, --checkpoint <n>: Saves the complete simulation state every <n> ticks, to the scene file's name with extension '.ckpt'. "
+    << "Written in the background, the ticks don't wait for the disk. Not with '--stream'.\n"
+    << "  -R, --resume: Treats every given file as a checkpoint and continues the simulation from it, with the same results as if it never stopped. "
+    << "Needs the same '--iterations' as when it was taken.\n"
+    << "  -o, --record <n>: Records position, rotation & velocities of every body every <n> ticks, to the scene file's name with extension '.traj'. "
+    << "Written in the background, delta encoded.\n"
+    << "  -q, --quantise <x>: Rounds recorded values to multiples of <x> (e.g. 0.01), which makes trajectories a lot smaller (default: lossless).\n"
+    << "  -T, --trajectory <tick>: Prints the recorded bodies at <tick> from every given trajectory file instead of running it.\n"
+    << "  -x, --self-test: Checks the vector separating axis kernels against the scalar one on random polygon pairs, "
+    << "for every instruction set this cpu supports, instead of running scenes.\n"
+    << "  -P, --parser-benchmark: Measures parser throughput (MB/s) on every given text scene file for every supported instruction set instead of running it. "
+    << "'scenes/generate.py' writes large scenes to measure with.\n"
+    << "  -j, --jobs <n>: Number of scenes simulated at the same time, needs '--headless' (default: 1).\n"
     << "\n";
 }
 
 
 
+//------------------------------------------------------------------------------
+void App::set_headless(bool headless){
+  this->headless = headless;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_threads(uint thread_count){
+  if(thread_count < 1)
+    throw std::runtime_error("Thread count has to be at least 1.");
+  
+  this->thread_count = thread_count;
+  file_handler.set_threads(thread_count);   // one pool for every file, see 'load_scene()'
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_tick_rate(uint tick_rate){
+  if(tick_rate < 1)
+    throw std::runtime_error("Tick rate has to be at least 1.");
+  
+  this->tick_rate = tick_rate;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_frame_rate(uint frame_rate){
+  if(frame_rate < 1)
+    throw std::runtime_error("Frame rate has to be at least 1.");
+  
+  this->frame_rate = frame_rate;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_speed(float speed){
+  if( !(speed > 0.0f) )
+    throw std::runtime_error("Speed has to be greater than 0.");
+  
+  this->speed = speed;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_unthrottled(bool unthrottled){
+  this->unthrottled = unthrottled;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_jobs(uint jobs){
+  if(jobs < 1)
+    throw std::runtime_error("Job count has to be at least 1.");
+  
+  this->jobs = jobs;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_show_contacts(bool show_contacts){
+  this->show_contacts = show_contacts;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_solver_iterations(uint iterations){
+  if(iterations < 1)
+    throw std::runtime_error("Solver iterations have to be at least 1.");
+  
+  this->solver_iterations = iterations;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_convert(bool convert){
+  this->convert = convert;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_streaming(bool streaming){
+  this->streaming = streaming;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_parser_benchmark(bool parser_benchmark){
+  this->parser_benchmark = parser_benchmark;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_cache_directory(const std::string& directory){
+  cache = std::make_shared< Scene_Cache >(directory);
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_checkpoint_interval(uint ticks){
+  if(ticks < 1)
+    throw std::runtime_error("Checkpoint interval has to be at least 1 tick.");
+  
+  checkpoint_interval = ticks;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_resume(bool resume){
+  this->resume = resume;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_recording(uint interval){
+  if(interval < 1)
+    throw std::runtime_error("Recording interval has to be at least 1 tick.");
+  
+  record_interval = interval;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_quantisation(float step){
+  if( !(step > 0.0f) )
+    throw std::runtime_error("Quantisation step has to be greater than 0.");
+  
+  record_step = step;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_trajectory_tick(uint tick){
+  print_trajectory = true;
+  trajectory_tick = tick;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::set_self_test(bool self_test){
+  this->self_test = self_test;
+}
+
+
+
 //------------------------------------------------------------------------------
 void App::run(const std::vector< std::string >& file_names){  
+  if(convert){
+    convert_files(file_names);
+    return;
+  }
+  
+  if(self_test){
+    if( ! Sat_Kernel::self_test(std::cout))
+      throw std::runtime_error("Self test failed, a vector kernel differs from the scalar one.");
+    return;
+  }
+  
+  if(print_trajectory){
+    for(auto &f : file_names)
+      print_trajectory_file(f);
+    return;
+  }
+  
+  if(parser_benchmark){
+    for(auto &f : file_names)
+      file_handler.benchmark(f);
+    return;
+  }
+  
+  if(jobs > 1 && file_names.size() > 1){
+    run_concurrent(file_names);
+    return;
+  }
+  
+  // a failing scene is skipped, as in run_concurrent
   for(auto &f : file_names){
-    std::shared_ptr<Scene> scene = std::make_shared<Scene>();
-    file_handler.process(f, scene);
-    scene->start();
+    try{
+      std::shared_ptr<Scene> scene = create_scene();
+      if( ! load_scene(f, scene, file_handler))
+        continue;   // already reported, on to the next one
+      scene->start();
+    }
+    catch(std::exception& e){
+      std::cerr << "Error: " + std::string(e.what()) + "\nScene '" + f + "' skipped.\n";
+    }
   }
 }
 
@@ -62,3 +296,163 @@ void App::run(const std::vector< std::string >& file_names){
 ////////////////////////////////////////////////////////////////////////////////
 // private
 ////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+//------------------------------------------------------------------------------
+std::shared_ptr< Scene > App::create_scene(){
+  std::shared_ptr<Scene> scene = std::make_shared<Scene>(headless);
+  scene->set_threads(thread_count);
+  scene->set_tick_rate(tick_rate);
+  scene->set_frame_rate(frame_rate);
+  scene->set_speed(speed);
+  scene->set_unthrottled(unthrottled);
+  scene->set_show_contacts(show_contacts);
+  scene->set_solver_iterations(solver_iterations);
+  
+  return scene;
+}
+
+
+
+//------------------------------------------------------------------------------
+bool App::load_scene(const std::string& file_name, std::shared_ptr< Scene > scene, File_Handler& handler){
+  if(checkpoint_interval > 0)
+    scene->set_checkpoints(checkpoint_interval, replace_extension(file_name, ".ckpt"));
+  if(record_interval > 0)
+    scene->set_recording(record_interval, record_step, replace_extension(file_name, ".traj"));
+  
+  if(resume){
+    // reported & false like the other loaders, a broken checkpoint is one failed scene
+    try{  scene->load_checkpoint(file_name);  }
+    catch(std::exception& e){
+      std::cerr << "Error: Unable to load checkpoint '" + file_name + "'!\n" + e.what() + "\n";
+      return false;
+    }
+    return true;
+  }
+  
+  if( ! streaming){
+    if(cache)
+      return cache->load(file_name, handler, scene);
+    return handler.process(file_name, scene);
+  }
+  
+  // handler stays with the scene, reading on demand
+  std::shared_ptr< File_Handler > stream_handler = std::make_shared< File_Handler >();
+  if( ! stream_handler->stream(file_name, scene))
+    return false;
+  scene->set_object_stream(stream_handler);
+  return true;
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::run_concurrent(const std::vector< std::string >& file_names){
+  // there is only one window
+  if( ! headless)
+    throw std::runtime_error("Running several scenes at the same time ('--jobs') needs '--headless'.");
+  
+  Thread_Pool pool( std::min< std::size_t >(jobs, file_names.size()) );
+  std::mutex print_mutex;
+  std::size_t total_ticks = 0;
+  std::size_t failed = 0;
+  auto time_start = std::chrono::steady_clock::now();
+  
+  pool.run(file_names.size(), [&](std::size_t i){
+    // every scene gets its own parser & report, printed in one piece once done
+    std::ostringstream report;
+    uint ticks = 0;
+    bool ok = true;
+    
+    try{
+      std::shared_ptr<Scene> scene = create_scene();
+      scene->set_output(report);
+      File_Handler handler;   // single threaded, the scenes are the parallel part
+      if(load_scene(file_names[i], scene, handler)){
+        scene->start();
+        ticks = scene->get_ticks_passed();
+      }
+      else{
+        report << "Error: Unable to load scene, skipped.\n";
+        ok = false;
+      }
+    }
+    catch(std::exception& e){
+      report << "Error: " << e.what() << "\n";
+      ok = false;
+    }
+    
+    std::lock_guard<std::mutex> lock(print_mutex);
+    std::cout << "Scene '" << file_names[i] << "':\n" << report.str();
+    total_ticks += ticks;
+    failed += ok ? 0 : 1;
+  });
+  
+  // all scenes together
+  double seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - time_start).count();
+  double divisor = std::max(seconds, 1e-6);
+  std::cout
+    << "Ran " << file_names.size() << " scenes on " << pool.get_thread_count() << " worker(s) in " << seconds << " s wall time: "
+    << total_ticks << " ticks (" << total_ticks / divisor << " ticks/s, " << file_names.size() / divisor << " scenes/s)"
+    << ", " << failed << " failed";
+  if(cache)
+    std::cout << ", scene cache: " << cache->get_hit_count() << " hit(s), " << cache->get_miss_count() << " miss(es)";
+  std::cout << ".\n";
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::convert_files(const std::vector< std::string >& file_names){
+  for(auto &f : file_names){
+    std::string binary_name = replace_extension(f, ".bin");
+    if(binary_name == f)
+      throw std::runtime_error("Converting '" + f + "' would overwrite it.");
+    
+    file_handler.convert(f, binary_name);
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void App::print_trajectory_file(const std::string& file_name){
+  Trajectory_Reader reader(file_name);
+  trajectory_frame frame;
+  
+  std::cout << "Trajectory '" << file_name << "': " << reader.get_frame_count() << " frames, every " << reader.get_interval() << " ticks, ";
+  if(reader.is_quantised())
+    std::cout << "quantised to " << reader.get_step() << ".\n";
+  else
+    std::cout << "lossless.\n";
+  
+  if( ! reader.read_at(trajectory_tick, frame)){
+    std::cout << "Nothing recorded at or before tick " << trajectory_tick << ".\n";
+    return;
+  }
+  
+  std::cout << "Tick " << frame.tick << ", " << frame.ids.size() << " bodies (id: position, rotation, velocity, angular velocity):\n";
+  for(std::size_t i = 0; i < frame.ids.size(); i++)
+    std::cout
+      << "  " << frame.ids[i] << ": "
+      << "(" << frame.position[i].x << ", " << frame.position[i].y << "), "
+      << frame.rotation[i] << ", "
+      << "(" << frame.velocity[i].x << ", " << frame.velocity[i].y << "), "
+      << frame.angular_velocity[i] << "\n";
+}
+
+
+
+//------------------------------------------------------------------------------
+std::string App::replace_extension(const std::string& file_name, const std::string& extension){
+  std::string name = file_name;
+  std::size_t dot = name.find_last_of('.');
+  std::size_t slash = name.find_last_of('/');
+  if(dot != std::string::npos && (slash == std::string::npos || dot > slash))
+    name.erase(dot);
+  
+  return name + extension;
+}
\ No newline at end of file
@@ -31,6 +31,7 @@ SOFTWARE.
 #include <memory>
 
 #include "file_handler.h"
+#include "scene_cache.h"
 #include "scene.h"
 
 
@@ -38,8 +39,54 @@ SOFTWARE.
 class App{
 public:
   void print_help();
+  void set_headless(bool headless);
+  void set_threads(uint thread_count);
+  void set_tick_rate(uint tick_rate);
+  void set_frame_rate(uint frame_rate);
+  void set_speed(float speed);
+  void set_unthrottled(bool unthrottled);
+  void set_jobs(uint jobs);
+  void set_show_contacts(bool show_contacts);
+  void set_solver_iterations(uint iterations);
+  void set_convert(bool convert);
+  void set_streaming(bool streaming);
+  void set_parser_benchmark(bool parser_benchmark);
+  void set_cache_directory(const std::string& directory);
+  void set_checkpoint_interval(uint ticks);
+  void set_resume(bool resume);
+  void set_recording(uint interval);
+  void set_quantisation(float step);
+  void set_trajectory_tick(uint tick);
+  void set_self_test(bool self_test);
   void run(const std::vector< std::string >& file_names);
   
 private:
-  File_Handler file_handler;
+  File_Handler file_handler;   // reused for every file, except with '--jobs'
+  bool headless = false;
+  uint thread_count = 1;
+  uint tick_rate = 100;
+  uint frame_rate = 60;
+  float speed = 1.0f;
+  bool unthrottled = false;
+  uint jobs = 1;   // scenes simulated at the same time
+  bool show_contacts = false;
+  uint solver_iterations = 10;
+  bool convert = false;   // write binary scene files instead of running them
+  bool streaming = false;   // read objects while running, shortly before they spawn
+  bool parser_benchmark = false;   // measure how fast scene files parse instead of running them
+  std::shared_ptr< Scene_Cache > cache;   // null -> parse every time
+  uint checkpoint_interval = 0;   // ticks, 0 -> no checkpoints
+  bool resume = false;   // files are checkpoints, not scenes
+  uint record_interval = 0;   // ticks, 0 -> no trajectory
+  float record_step = 0.0f;   // 0 -> lossless
+  bool print_trajectory = false;   // files are trajectories, print the bodies at 'trajectory_tick'
+  uint trajectory_tick = 0;
+  bool self_test = false;   // check the vector kernels instead of running scenes
+  
+  std::shared_ptr< Scene > create_scene();
+  bool load_scene(const std::string& file_name, std::shared_ptr< Scene > scene, File_Handler& handler);   // false on error
+  void run_concurrent(const std::vector< std::string >& file_names);
+  void convert_files(const std::vector< std::string >& file_names);
+  void print_trajectory_file(const std::string& file_name);
+  static std::string replace_extension(const std::string& file_name, const std::string& extension);
 };
\ No newline at end of file
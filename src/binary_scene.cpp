@@ -0,0 +1,266 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "binary_scene.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+
+
+bool Binary_Scene::is_binary(Mapped_File& file){
+  return file.size() >= sizeof(magic) && std::memcmp(file.begin(), magic, sizeof(magic)) == 0;
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Binary_Scene::load(Mapped_File& file, Scene_Target& target){
+  binary_scene_info info = load_header(file, target);
+  
+  for(uint64_t i = 0; i < info.object_count; i++){
+    object_description obj = load_object(file, info, i);
+    target.add_object(obj.position, obj.rotation, obj.size, obj.colour, obj.time, obj.type);
+  }
+  
+  return info.object_count;
+}
+
+
+
+//------------------------------------------------------------------------------
+binary_scene_info Binary_Scene::load_header(Mapped_File& file, Scene_Target& target){
+  binary_scene_header header;
+  if(file.size() < sizeof(header))
+    throw std::runtime_error("Invalid binary scene! File too small for header.");
+  std::memcpy(&header, file.begin(), sizeof(header));
+  
+  bool swap = header.endian_marker != endian_marker;
+  if(swap)
+    swap_bytes(header);
+  if(header.endian_marker != endian_marker)
+    throw std::runtime_error("Invalid binary scene! Unknown byte order.");
+  
+  if(header.version != version){
+    std::stringstream message;
+    message << "Invalid binary scene! Version " << header.version << " is not supported (expected " << version << ").";
+    throw std::runtime_error(message.str());
+  }
+  if(header.header_size != sizeof(binary_scene_header) || header.record_size != sizeof(binary_scene_record))
+    throw std::runtime_error("Invalid binary scene! Header or record size does not match.");
+  if(header.broadphase > bp_aabb_tree)
+    throw std::runtime_error("Invalid binary scene! Unknown broadphase.");
+  if(
+    (uint64_t) header.header_size + header.name_length > header.object_offset ||
+    header.object_offset > file.size() ||
+    header.object_count > (file.size() - header.object_offset) / sizeof(binary_scene_record)
+  )
+    throw std::runtime_error("Invalid binary scene! Objects reach past end of file.");
+  
+  // scene
+  target.set_name( std::string(file.begin() + header.header_size, header.name_length) );
+  target.set_background_colour( {header.background[0], header.background[1], header.background[2]} );
+  target.set_time(header.time);
+  target.set_broadphase( (broadphase_type) header.broadphase );
+  
+  return {header.object_count, header.object_offset, swap};
+}
+
+
+
+//------------------------------------------------------------------------------
+object_description Binary_Scene::load_object(Mapped_File& file, const binary_scene_info& info, uint64_t i){
+  // straight from the mapping, no alignment assumptions, compiles down to plain loads
+  binary_scene_record r;
+  std::memcpy(&r, file.begin() + info.object_offset + i * sizeof(r), sizeof(r));
+  if(info.swap)
+    swap_bytes(r);
+  
+  if(r.type > circle){
+    std::stringstream message;
+    message << "Invalid binary scene! Unknown object type in record " << i << ".";
+    throw std::runtime_error(message.str());
+  }
+  
+  return {
+    {r.position[0], r.position[1]},
+    r.rotation,
+    r.size,
+    {r.colour[0], r.colour[1], r.colour[2]},
+    r.time,
+    (phy_obj_type) r.type
+  };
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t Binary_Scene::swap_bytes(uint32_t value){
+  return __builtin_bswap32(value);
+}
+
+
+
+//------------------------------------------------------------------------------
+uint64_t Binary_Scene::swap_bytes(uint64_t value){
+  return __builtin_bswap64(value);
+}
+
+
+
+//------------------------------------------------------------------------------
+float Binary_Scene::swap_bytes(float value){
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  bits = swap_bytes(bits);
+  std::memcpy(&value, &bits, sizeof(bits));
+  
+  return value;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Binary_Scene::swap_bytes(binary_scene_header& header){
+  header.endian_marker = swap_bytes(header.endian_marker);
+  header.version = swap_bytes(header.version);
+  header.header_size = swap_bytes(header.header_size);
+  header.record_size = swap_bytes(header.record_size);
+  header.time = swap_bytes(header.time);
+  header.broadphase = swap_bytes(header.broadphase);
+  for(auto &b : header.background)
+    b = swap_bytes(b);
+  header.name_length = swap_bytes(header.name_length);
+  header.object_count = swap_bytes(header.object_count);
+  header.object_offset = swap_bytes(header.object_offset);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Binary_Scene::swap_bytes(binary_scene_record& record){
+  record.type = swap_bytes(record.type);
+  for(auto &p : record.position)
+    p = swap_bytes(p);
+  record.rotation = swap_bytes(record.rotation);
+  record.size = swap_bytes(record.size);
+  for(auto &c : record.colour)
+    c = swap_bytes(c);
+  record.time = swap_bytes(record.time);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// writer
+////////////////////////////////////////////////////////////////////////////////
+
+void Binary_Scene_Writer::set_name(const std::string& name){
+  this->name = name;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Binary_Scene_Writer::set_background_colour(glm::vec3 colour){
+  background = colour;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Binary_Scene_Writer::set_time(uint time){
+  this->time = time;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Binary_Scene_Writer::set_broadphase(broadphase_type type){
+  broadphase = type;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Binary_Scene_Writer::add_object(glm::vec2 pos, float rot, float size, glm::vec3 colour, uint time, phy_obj_type type){
+  records.push_back({
+    (uint32_t) type,
+    {pos.x, pos.y},
+    rot,
+    size,
+    {colour.x, colour.y, colour.z},
+    time
+  });
+}
+
+
+
+//------------------------------------------------------------------------------
+void Binary_Scene_Writer::write(const std::string& file_name){
+  // same tick -> file order, same as 'Spawn_Schedule'
+  std::stable_sort(records.begin(), records.end(), [](auto& r_0, auto& r_1){  return r_0.time < r_1.time;  });
+  
+  binary_scene_header header = {};
+  std::memcpy(header.magic, Binary_Scene::magic, sizeof(header.magic));
+  header.endian_marker = Binary_Scene::endian_marker;
+  header.version = Binary_Scene::version;
+  header.header_size = sizeof(binary_scene_header);
+  header.record_size = sizeof(binary_scene_record);
+  header.time = time;
+  header.broadphase = broadphase;
+  header.background[0] = background.x;
+  header.background[1] = background.y;
+  header.background[2] = background.z;
+  header.name_length = name.size();
+  header.object_count = records.size();
+  header.object_offset = (sizeof(header) + name.size() + 7) / 8 * 8;   // records 8 byte aligned
+  
+  std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+  if( ! file)
+    throw std::runtime_error("Unable to open file '" + file_name + "' for writing!");
+  
+  const char padding[8] = {};
+  file.write(reinterpret_cast< const char* >(&header), sizeof(header));
+  file.write(name.data(), name.size());
+  file.write(padding, header.object_offset - sizeof(header) - name.size());
+  file.write(reinterpret_cast< const char* >(records.data()), records.size() * sizeof(binary_scene_record));
+  
+  if( ! file)
+    throw std::runtime_error("Unable to write file '" + file_name + "'!");
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Binary_Scene_Writer::get_object_count(){  return records.size();  }
\ No newline at end of file
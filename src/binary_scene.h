@@ -0,0 +1,127 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "scene_target.h"
+#include "mapped_file.h"
+
+
+
+// binary scene file, version 1:
+//   header | name (not terminated) | padding to 8 bytes | records
+// all numbers in the byte order of the machine that wrote it, see 'endian_marker'
+struct binary_scene_header{
+  char magic[8];   // "2DPHYSCN"
+  uint32_t endian_marker;   // 0x01020304
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t record_size;
+  uint32_t time;
+  uint32_t broadphase;   // 'broadphase_type'
+  float background[3];
+  uint32_t name_length;
+  uint64_t object_count;
+  uint64_t object_offset;   // from start of file
+};
+static_assert(sizeof(binary_scene_header) == 64, "'scenes/specification' documents 64 bytes");
+
+
+
+struct binary_scene_record{
+  uint32_t type;   // 'phy_obj_type'
+  float position[2];
+  float rotation;
+  float size;
+  float colour[3];
+  uint32_t time;
+};
+static_assert(sizeof(binary_scene_record) == 36, "'scenes/specification' documents 36 bytes");
+
+
+
+struct binary_scene_info{   // what is needed to read records after the header
+  uint64_t object_count;
+  uint64_t object_offset;
+  bool swap;   // written with the other byte order
+};
+
+
+
+// reads binary scene files straight from the mapping
+class Binary_Scene{
+public:
+  static constexpr char magic[8] = {'2', 'D', 'P', 'H', 'Y', 'S', 'C', 'N'};
+  static constexpr uint32_t endian_marker = 0x01020304;
+  static constexpr uint32_t version = 1;
+  
+  static bool is_binary(Mapped_File& file);
+  static std::size_t load(Mapped_File& file, Scene_Target& target);   // returns object count
+  static binary_scene_info load_header(Mapped_File& file, Scene_Target& target);   // scene settings only
+  static object_description load_object(Mapped_File& file, const binary_scene_info& info, uint64_t i);
+  
+private:
+  static uint32_t swap_bytes(uint32_t value);
+  static uint64_t swap_bytes(uint64_t value);
+  static float swap_bytes(float value);
+  static void swap_bytes(binary_scene_header& header);
+  static void swap_bytes(binary_scene_record& record);
+};
+
+
+
+//------------------------------------------------------------------------------
+// collects a parsed text scene & writes it as binary scene file (converter mode)
+class Binary_Scene_Writer : public Scene_Target{
+public:
+  void set_name(const std::string& name);
+  void set_background_colour(glm::vec3 colour);
+  void set_time(uint time);
+  void set_broadphase(broadphase_type type);
+  void add_object(
+    glm::vec2 position,
+    float rotation,
+    float size,
+    glm::vec3 colour,
+    uint time,
+    phy_obj_type type
+  );
+  void write(const std::string& file_name);
+  std::size_t get_object_count();
+  
+private:
+  std::string name;
+  glm::vec3 background = {0.0f, 0.0f, 0.0f};
+  uint time = 0;
+  broadphase_type broadphase = bp_sweep_prune;   // same default as 'Scene'
+  std::vector< binary_scene_record > records;   // sorted by spawn tick when written -> always streamable
+};
\ No newline at end of file
@@ -0,0 +1,379 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "body_store.h"
+
+#include <math.h>
+#include <exception>
+#include <stdexcept>
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// public
+////////////////////////////////////////////////////////////////////////////////
+
+body_id Body_Store::add(glm::vec2 position, float rotation, float mass, float inertia_tensor, float bounciness, shape_id shape, const body_cold& cold){
+  body_id body = this->cold.size();
+  
+  index.push_back( ids.size() );
+  ids.push_back(body);
+  this->position.push_back(position);
+  this->rotation.push_back( fmod(rotation, 360.0f) );
+  this->velocity.push_back( {0.0f, 0.0f} );
+  this->angular_velocity.push_back(0.0f);
+  this->torque.push_back(0.0f);
+  this->mass.push_back(mass);
+  this->inertia_tensor.push_back(inertia_tensor);
+  this->bounciness.push_back(bounciness);
+  this->shape.push_back(shape);
+  this->prev_position.push_back(position);
+  this->prev_rotation.push_back( this->rotation.back() );
+  this->rest_time.push_back(0.0f);
+  this->awake.push_back(1);
+  this->cold.push_back(cold);
+  
+  // room in world cache
+  const body_shape& s = shapes[shape];
+  world_point_offset.push_back( world_points.size() );
+  world_axis_offset.push_back( world_axes.size() );
+  world_points.resize( world_points.size() + s.points.size() );
+  world_axes.resize( world_axes.size() + s.axes.size() );
+  update_world_cache( ids.size() - 1 );
+  
+  return body;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Body_Store::reserve(std::size_t count){
+  std::size_t dense = ids.size() + count;
+  std::size_t all = cold.size() + count;   // body ids are never reused
+  
+  index.reserve(all);
+  cold.reserve(all);
+  ids.reserve(dense);
+  position.reserve(dense);
+  rotation.reserve(dense);
+  velocity.reserve(dense);
+  angular_velocity.reserve(dense);
+  torque.reserve(dense);
+  mass.reserve(dense);
+  inertia_tensor.reserve(dense);
+  bounciness.reserve(dense);
+  shape.reserve(dense);
+  prev_position.reserve(dense);
+  prev_rotation.reserve(dense);
+  rest_time.reserve(dense);
+  awake.reserve(dense);
+  world_point_offset.reserve(dense);
+  world_axis_offset.reserve(dense);
+}
+
+
+
+//------------------------------------------------------------------------------
+shape_id Body_Store::add_shape(const body_shape& shape){
+  auto key = std::make_pair( (int) shape.type, shape.size );
+  auto found = shape_lookup.find(key);
+  if(found != shape_lookup.end())
+    return found->second;
+  
+  shape_id s = shapes.size();
+  shapes.push_back(shape);
+  shape_lookup[key] = s;
+  
+  return s;
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Body_Store::size(){  return ids.size();  }
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Body_Store::index_of(body_id body){  return index[body];  }
+
+
+
+//------------------------------------------------------------------------------
+const body_shape& Body_Store::get_shape(std::size_t i){  return shapes[ shape[i] ];  }
+
+
+
+//------------------------------------------------------------------------------
+bool Body_Store::is_circle(std::size_t i){  return get_shape(i).radius > 0.0f;  }
+
+
+
+//------------------------------------------------------------------------------
+std::span< const glm::vec2 > Body_Store::get_world_points(std::size_t i){
+  return { world_points.data() + world_point_offset[i], get_shape(i).points.size() };
+}
+
+
+
+//------------------------------------------------------------------------------
+std::span< const glm::vec2 > Body_Store::get_world_axes(std::size_t i){
+  return { world_axes.data() + world_axis_offset[i], get_shape(i).axes.size() };
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Body_Store::is_awake(std::size_t i){  return awake[i];  }
+
+
+
+//------------------------------------------------------------------------------
+void Body_Store::sleep(std::size_t i){
+  awake[i] = 0;
+  velocity[i] = {0.0f, 0.0f};
+  angular_velocity[i] = 0.0f;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Body_Store::wake(std::size_t i){
+  if(awake[i])
+    return;
+  
+  awake[i] = 1;
+  rest_time[i] = 0.0f;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Body_Store::integrate(float step_time){
+  prev_position = position;   // same size -> no allocation
+  prev_rotation = rotation;
+  
+  for(std::size_t i = 0; i < ids.size(); i++){
+    if( ! awake[i])
+      continue;
+    
+    // rotation
+    rotation[i] = fmod(rotation[i] + step_time * angular_velocity[i], 360.0f);
+    angular_velocity[i] += step_time * (torque[i] / inertia_tensor[i]);
+    torque[i] = 0.0f;
+    
+    // position
+    position[i] += step_time * velocity[i];
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Body_Store::update_world_cache(){
+  for(std::size_t i = 0; i < ids.size(); i++)
+    if(awake[i])
+      update_world_cache(i);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Body_Store::apply_force(std::size_t i, glm::vec2 force, glm::vec2 pos){
+  wake(i);
+  torque[i] = cross_2d(force, pos);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Body_Store::apply_impulse(std::size_t i, glm::vec2 impulse, glm::vec2 arm){
+  // linear velocity
+  velocity[i] += impulse * (1.0f / mass[i]);
+  
+  // angular velocity
+  angular_velocity[i] += glm::degrees( cross_2d(arm, impulse) * (1.0f / inertia_tensor[i]) );
+}
+
+
+
+//------------------------------------------------------------------------------
+glm::vec2 Body_Store::get_point_velocity(std::size_t i, glm::vec2 arm){
+  float spin = glm::radians(angular_velocity[i]);
+  return velocity[i] + spin * glm::vec2( - arm.y, arm.x);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Body_Store::save(Checkpoint_Out& out){
+  // hot, dense order
+  out.write_array(ids);
+  out.write_array(position);
+  out.write_array(rotation);
+  out.write_array(velocity);
+  out.write_array(angular_velocity);
+  out.write_array(torque);
+  out.write_array(mass);
+  out.write_array(inertia_tensor);
+  out.write_array(bounciness);
+  out.write_array(shape);
+  out.write_array(prev_position);
+  out.write_array(prev_rotation);
+  out.write_array(rest_time);
+  out.write_array(awake);
+  out.write_array(index);
+  
+  // shared & cold, world cache follows from these
+  out.write_value< uint64_t >( shapes.size() );
+  for(auto &s : shapes){
+    out.write_value(s.type);
+    out.write_value(s.size);
+    out.write_array(s.points);
+    out.write_array(s.axes);
+    out.write_value(s.center_of_mass);
+    out.write_value(s.bounding_radius);
+    out.write_value(s.radius);
+  }
+  
+  out.write_value< uint64_t >( cold.size() );
+  for(auto &c : cold){
+    out.write_value(c.colour);
+    out.write_value(c.time);
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Body_Store::load(Checkpoint_In& in){
+  in.read_array(ids);
+  in.read_array(position);
+  in.read_array(rotation);
+  in.read_array(velocity);
+  in.read_array(angular_velocity);
+  in.read_array(torque);
+  in.read_array(mass);
+  in.read_array(inertia_tensor);
+  in.read_array(bounciness);
+  in.read_array(shape);
+  in.read_array(prev_position);
+  in.read_array(prev_rotation);
+  in.read_array(rest_time);
+  in.read_array(awake);
+  in.read_array(index);
+  
+  shapes.resize( in.read_value< uint64_t >() );
+  shape_lookup.clear();
+  for(shape_id s = 0; s < shapes.size(); s++){
+    shapes[s].type = in.read_value< phy_obj_type >();
+    shapes[s].size = in.read_value< float >();
+    in.read_array(shapes[s].points);
+    in.read_array(shapes[s].axes);
+    shapes[s].center_of_mass = in.read_value< glm::vec2 >();
+    shapes[s].bounding_radius = in.read_value< float >();
+    shapes[s].radius = in.read_value< float >();
+    shape_lookup[ std::make_pair( (int) shapes[s].type, shapes[s].size ) ] = s;
+  }
+  
+  cold.resize( in.read_value< uint64_t >() );
+  for(auto &c : cold){
+    c.colour = in.read_value< glm::vec3 >();
+    c.time = in.read_value< uint >();
+    c.gobj_id = 0;
+  }
+  
+  // everything has to fit together before anything indexes with it
+  std::size_t n = ids.size();
+  for(std::size_t size : {position.size(), rotation.size(), velocity.size(), angular_velocity.size(), torque.size(), mass.size(),
+    inertia_tensor.size(), bounciness.size(), shape.size(), prev_position.size(), prev_rotation.size(), rest_time.size(), awake.size()})
+    if(size != n)
+      throw std::runtime_error("Invalid checkpoint! Body arrays differ in size.");
+  if(index.size() != cold.size())
+    throw std::runtime_error("Invalid checkpoint! Body ids don't match.");
+  for(std::size_t i = 0; i < n; i++)
+    if(ids[i] >= index.size() || index[ ids[i] ] != i || shape[i] >= shapes.size())
+      throw std::runtime_error("Invalid checkpoint! Body ids or shapes don't match.");
+  
+  rebuild_world_cache_layout();
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////////////
+
+void Body_Store::update_world_cache(std::size_t i){
+  const body_shape& s = get_shape(i);
+  float sine = sin( glm::radians(rotation[i]) );
+  float cosine = cos( glm::radians(rotation[i]) );
+  
+  // points: rotate & move
+  glm::vec2* points = world_points.data() + world_point_offset[i];
+  for(std::size_t p = 0; p < s.points.size(); p++){
+    glm::vec2 local = s.points[p];
+    points[p].x = local.x * cosine - local.y * sine + position[i].x;
+    points[p].y = local.x * sine + local.y * cosine + position[i].y;
+  }
+  
+  // axes: rotate only
+  glm::vec2* axes = world_axes.data() + world_axis_offset[i];
+  for(std::size_t a = 0; a < s.axes.size(); a++){
+    glm::vec2 local = s.axes[a];
+    axes[a].x = local.x * cosine - local.y * sine;
+    axes[a].y = local.x * sine + local.y * cosine;
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Body_Store::rebuild_world_cache_layout(){
+  world_point_offset.clear();
+  world_axis_offset.clear();
+  std::size_t point_count = 0;
+  std::size_t axis_count = 0;
+  
+  for(std::size_t i = 0; i < ids.size(); i++){
+    world_point_offset.push_back(point_count);
+    world_axis_offset.push_back(axis_count);
+    point_count += get_shape(i).points.size();
+    axis_count += get_shape(i).axes.size();
+  }
+  
+  world_points.resize(point_count);
+  world_axes.resize(axis_count);
+  for(std::size_t i = 0; i < ids.size(); i++)
+    update_world_cache(i);
+}
+
+
+
+//------------------------------------------------------------------------------
+float Body_Store::cross_2d(glm::vec2 v_0, glm::vec2 v_1){
+  return v_0.x * v_1.y - v_0.y * v_1.x;
+}
\ No newline at end of file
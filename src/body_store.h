@@ -0,0 +1,145 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <map>
+#include <utility>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "render_sink.h"
+#include "checkpoint.h"
+
+
+
+typedef uint body_id;   // stable for the lifetime of a body, indexes 'cold' (see 'index_of()' for the hot arrays)
+typedef uint shape_id;
+
+
+
+struct body_shape{   // shared by all bodies of same type & size
+  phy_obj_type type;
+  float size;
+  std::vector< glm::vec2 > points;   // object space, order of points matters! (empty for circles)
+  std::vector< glm::vec2 > axes;   // unique edge normals, object space (empty for circles)
+  glm::vec2 center_of_mass;
+  float bounding_radius;
+  float radius;   // circles only, 0 for polygons
+};
+
+
+
+struct prepared_object{   // everything a body needs, shape already added to 'Body_Store'
+  phy_obj_type type;
+  glm::vec2 position;
+  float rotation;
+  float size;
+  glm::vec3 colour;
+  uint time;
+  float mass;
+  float inertia_tensor;
+  float bounciness;
+  shape_id shape;
+};
+
+
+
+struct body_cold{   // not needed for physics, indexed by body_id
+  glm::vec3 colour;
+  uint time;
+  id gobj_id;
+};
+
+
+
+// rigid body state as structure-of-arrays, hot arrays are indexed densely (see 'index_of()')
+class Body_Store{
+public:
+  body_id add(
+    glm::vec2 position,
+    float rotation,
+    float mass,
+    float inertia_tensor,
+    float bounciness,
+    shape_id shape,
+    const body_cold& cold
+  );
+  void reserve(std::size_t count);   // room for 'count' more bodies
+  shape_id add_shape(const body_shape& shape);
+  std::size_t size();
+  std::size_t index_of(body_id body);
+  const body_shape& get_shape(std::size_t i);
+  bool is_circle(std::size_t i);
+  std::span< const glm::vec2 > get_world_points(std::size_t i);
+  std::span< const glm::vec2 > get_world_axes(std::size_t i);
+  bool is_awake(std::size_t i);
+  void sleep(std::size_t i);
+  void wake(std::size_t i);
+  void integrate(float step_time);   // awake bodies only
+  void update_world_cache();   // awake bodies only
+  void apply_force(std::size_t i, glm::vec2 force, glm::vec2 position);
+  void apply_impulse(std::size_t i, glm::vec2 impulse, glm::vec2 arm);   // arm: world space, center -> point of impact
+  glm::vec2 get_point_velocity(std::size_t i, glm::vec2 arm);
+  void save(Checkpoint_Out& out);
+  void load(Checkpoint_In& in);   // replaces every body, gobj ids are left to the caller
+  
+  // hot
+  std::vector< body_id > ids;
+  std::vector< glm::vec2 > position;
+  std::vector< float > rotation;
+  std::vector< glm::vec2 > velocity;
+  std::vector< float > angular_velocity;   // degrees per second, like 'rotation'
+  std::vector< float > torque;
+  std::vector< float > mass;
+  std::vector< float > inertia_tensor;
+  std::vector< float > bounciness;   // keep between 0 and 1 !
+  std::vector< shape_id > shape;
+  std::vector< glm::vec2 > prev_position;   // state before the last 'integrate()', for render interpolation
+  std::vector< float > prev_rotation;
+  std::vector< float > rest_time;   // seconds spent nearly still, see 'Islands'
+  std::vector< uint8_t > awake;   // sleeping bodies are neither integrated nor tested against each other
+  
+  // world space points & axes of all bodies back to back, refreshed once per tick
+  std::vector< glm::vec2 > world_points;
+  std::vector< glm::vec2 > world_axes;
+  std::vector< std::size_t > world_point_offset;
+  std::vector< std::size_t > world_axis_offset;
+  
+  // shared & cold
+  std::vector< body_shape > shapes;
+  std::vector< body_cold > cold;
+  
+private:
+  std::vector< std::size_t > index;   // body_id -> dense index
+  std::map< std::pair< int, float >, shape_id > shape_lookup;   // (type, size) -> shape
+  
+  void update_world_cache(std::size_t i);
+  void rebuild_world_cache_layout();
+  static float cross_2d(glm::vec2 v_0, glm::vec2 v_1);
+};
\ No newline at end of file
@@ -0,0 +1,483 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "broadphase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Broadphase public
+////////////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr< Broadphase > Broadphase::create(broadphase_type type){
+  switch(type){
+    case bp_brute_force: return std::make_shared<Brute_Force_Broadphase>();
+    case bp_grid:        return std::make_shared<Grid_Broadphase>();
+    case bp_sweep_prune: return std::make_shared<Sweep_Prune_Broadphase>();
+    case bp_aabb_tree:   return std::make_shared<AABB_Tree_Broadphase>();
+    default: throw std::runtime_error("Invalid broadphase type");
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Broadphase::overlap(const aabb& box_0, const aabb& box_1){
+  return box_0.min.x <= box_1.max.x && box_1.min.x <= box_0.max.x
+      && box_0.min.y <= box_1.max.y && box_1.min.y <= box_0.max.y;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Broadphase private
+////////////////////////////////////////////////////////////////////////////////
+
+void Broadphase::sort_pairs(std::vector< body_pair >& pairs){
+  // same pair order for every broadphase -> same simulation result
+  std::sort(pairs.begin(), pairs.end(), [](const body_pair& p_0, const body_pair& p_1){
+    if(p_0.i != p_1.i)
+      return p_0.i < p_1.i;
+    return p_0.j < p_1.j;
+  });
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Brute force public
+////////////////////////////////////////////////////////////////////////////////
+
+std::string Brute_Force_Broadphase::get_name(){  return "brute-force";  }
+
+
+
+//------------------------------------------------------------------------------
+void Brute_Force_Broadphase::find_pairs(const std::vector< aabb >& boxes, std::vector< body_pair >& pairs){
+  pairs.clear();
+  
+  for(uint i = 0; i < boxes.size(); i++)
+    for(uint j = i + 1; j < boxes.size(); j++)
+      pairs.push_back( {i, j} );
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Grid public
+////////////////////////////////////////////////////////////////////////////////
+
+std::string Grid_Broadphase::get_name(){  return "grid";  }
+
+
+
+//------------------------------------------------------------------------------
+void Grid_Broadphase::find_pairs(const std::vector< aabb >& boxes, std::vector< body_pair >& pairs){
+  pairs.clear();
+  entries.clear();
+  cell_size = calc_cell_size(boxes);
+  
+  // every box goes into every cell it touches (at most 4, cells are as big as the biggest box)
+  for(uint b = 0; b < boxes.size(); b++){
+    int64_t x_0 = cell_coord(boxes[b].min.x);
+    int64_t x_1 = cell_coord(boxes[b].max.x);
+    int64_t y_0 = cell_coord(boxes[b].min.y);
+    int64_t y_1 = cell_coord(boxes[b].max.y);
+    
+    for(int64_t x = x_0; x <= x_1; x++)
+      for(int64_t y = y_0; y <= y_1; y++)
+        entries.push_back( {cell_key(x, y), b} );
+  }
+  
+  std::sort(entries.begin(), entries.end(), [](const cell_entry& e_0, const cell_entry& e_1){
+    if(e_0.cell != e_1.cell)
+      return e_0.cell < e_1.cell;
+    return e_0.box < e_1.box;
+  });
+  
+  // test within each cell
+  for(std::size_t start = 0; start < entries.size(); ){
+    std::size_t end = start + 1;
+    while(end < entries.size() && entries[end].cell == entries[start].cell)
+      end++;
+    
+    for(std::size_t a = start; a < end; a++){
+      for(std::size_t b = a + 1; b < end; b++){
+        const aabb& box_a = boxes[ entries[a].box ];
+        const aabb& box_b = boxes[ entries[b].box ];
+        if( ! overlap(box_a, box_b))
+          continue;
+        
+        // a pair can share several cells, only report it in the one holding the corner of the overlap
+        int64_t x = cell_coord( std::max(box_a.min.x, box_b.min.x) );
+        int64_t y = cell_coord( std::max(box_a.min.y, box_b.min.y) );
+        if(cell_key(x, y) == entries[start].cell)
+          pairs.push_back( {entries[a].box, entries[b].box} );   // entries are sorted -> a < b
+      }
+    }
+    
+    start = end;
+  }
+  
+  sort_pairs(pairs);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Grid private
+////////////////////////////////////////////////////////////////////////////////
+
+float Grid_Broadphase::calc_cell_size(const std::vector< aabb >& boxes){
+  float size = 0.0f;
+  
+  for(auto &b : boxes){
+    size = std::max(size, b.max.x - b.min.x);
+    size = std::max(size, b.max.y - b.min.y);
+  }
+  
+  if(size <= 0.0f)
+    return 1.0f;
+  
+  return size;
+}
+
+
+
+//------------------------------------------------------------------------------
+int64_t Grid_Broadphase::cell_coord(float f){
+  return (int64_t) std::floor(f / cell_size);
+}
+
+
+
+//------------------------------------------------------------------------------
+uint64_t Grid_Broadphase::cell_key(int64_t x, int64_t y){
+  return ( (uint64_t) (uint32_t) x << 32 ) | (uint64_t) (uint32_t) y;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Sweep & prune public
+////////////////////////////////////////////////////////////////////////////////
+
+std::string Sweep_Prune_Broadphase::get_name(){  return "sweep-prune";  }
+
+
+
+//------------------------------------------------------------------------------
+void Sweep_Prune_Broadphase::find_pairs(const std::vector< aabb >& boxes, std::vector< body_pair >& pairs){
+  pairs.clear();
+  update_order(boxes);
+  
+  // sweep along x, only boxes starting before the current one ends can overlap
+  for(std::size_t a = 0; a < order.size(); a++){
+    const aabb& box_a = boxes[ order[a] ];
+    
+    for(std::size_t b = a + 1; b < order.size(); b++){
+      const aabb& box_b = boxes[ order[b] ];
+      if(box_b.min.x > box_a.max.x)
+        break;
+      
+      if(box_a.min.y <= box_b.max.y && box_b.min.y <= box_a.max.y)
+        pairs.push_back( {std::min(order[a], order[b]), std::max(order[a], order[b])} );
+    }
+  }
+  
+  sort_pairs(pairs);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Sweep & prune private
+////////////////////////////////////////////////////////////////////////////////
+
+void Sweep_Prune_Broadphase::update_order(const std::vector< aabb >& boxes){
+  if(order.size() > boxes.size())
+    order.clear();
+  
+  for(uint b = order.size(); b < boxes.size(); b++)
+    order.push_back(b);
+  
+  // insertion sort, boxes barely move between ticks
+  for(std::size_t i = 1; i < order.size(); i++){
+    uint current = order[i];
+    float key = boxes[current].min.x;
+    
+    std::size_t j = i;
+    for( ; j > 0 && boxes[ order[j - 1] ].min.x > key; j--)
+      order[j] = order[j - 1];
+      
+    order[j] = current;
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// AABB tree public
+////////////////////////////////////////////////////////////////////////////////
+
+std::string AABB_Tree_Broadphase::get_name(){  return "aabb-tree";  }
+
+
+
+//------------------------------------------------------------------------------
+void AABB_Tree_Broadphase::find_pairs(const std::vector< aabb >& boxes, std::vector< body_pair >& pairs){
+  pairs.clear();
+  sync_leaves(boxes);
+  
+  for(std::size_t i = 0; i < leaves.size(); i++)
+    query(leaves[i], boxes, pairs);
+  
+  sort_pairs(pairs);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// AABB tree private
+////////////////////////////////////////////////////////////////////////////////
+
+void AABB_Tree_Broadphase::sync_leaves(const std::vector< aabb >& boxes){
+  if(leaves.size() > boxes.size())
+    clear();
+  
+  // reinsert leaves that left their fat box
+  for(std::size_t i = 0; i < leaves.size(); i++){
+    int leaf = leaves[i];
+    if( contains(nodes[leaf].box, boxes[i]) )
+      continue;
+    
+    remove_leaf(leaf);
+    nodes[leaf].box = fatten(boxes[i]);
+    insert_leaf(leaf);
+  }
+  
+  // new boxes
+  for(std::size_t i = leaves.size(); i < boxes.size(); i++){
+    int leaf = allocate_node();
+    nodes[leaf].box = fatten(boxes[i]);
+    nodes[leaf].box_index = i;
+    insert_leaf(leaf);
+    leaves.push_back(leaf);
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+aabb AABB_Tree_Broadphase::fatten(const aabb& box){
+  glm::vec2 size = box.max - box.min;
+  float margin = margin_factor * std::max(size.x, size.y);
+  glm::vec2 offset = {margin, margin};
+  
+  return {box.min - offset, box.max + offset};
+}
+
+
+
+//------------------------------------------------------------------------------
+bool AABB_Tree_Broadphase::contains(const aabb& outer, const aabb& inner){
+  return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y
+      && inner.max.x <= outer.max.x && inner.max.y <= outer.max.y;
+}
+
+
+
+//------------------------------------------------------------------------------
+aabb AABB_Tree_Broadphase::combine(const aabb& box_0, const aabb& box_1){
+  return {
+    {std::min(box_0.min.x, box_1.min.x), std::min(box_0.min.y, box_1.min.y)},
+    {std::max(box_0.max.x, box_1.max.x), std::max(box_0.max.y, box_1.max.y)}
+  };
+}
+
+
+
+//------------------------------------------------------------------------------
+float AABB_Tree_Broadphase::perimeter(const aabb& box){
+  return 2.0f * ( (box.max.x - box.min.x) + (box.max.y - box.min.y) );
+}
+
+
+
+//------------------------------------------------------------------------------
+int AABB_Tree_Broadphase::allocate_node(){
+  if(free_nodes.empty()){
+    nodes.push_back( node() );
+    return nodes.size() - 1;
+  }
+  
+  int n = free_nodes.back();
+  free_nodes.pop_back();
+  nodes[n] = node();
+  return n;
+}
+
+
+
+//------------------------------------------------------------------------------
+void AABB_Tree_Broadphase::free_node(int n){
+  free_nodes.push_back(n);
+}
+
+
+
+//------------------------------------------------------------------------------
+void AABB_Tree_Broadphase::insert_leaf(int leaf){
+  if(root == null_node){
+    root = leaf;
+    nodes[leaf].parent = null_node;
+    return;
+  }
+  
+  // walk down to the cheapest sibling (perimeter heuristic)
+  aabb leaf_box = nodes[leaf].box;
+  int sibling = root;
+  
+  while( ! nodes[sibling].is_leaf()){
+    float area = perimeter(nodes[sibling].box);
+    float combined_area = perimeter( combine(nodes[sibling].box, leaf_box) );
+    float cost = 2.0f * combined_area;   // new parent for sibling & leaf
+    float inheritance = 2.0f * (combined_area - area);   // growth pushed down to children
+    
+    float child_cost[2];
+    int children[2] = {nodes[sibling].child_0, nodes[sibling].child_1};
+    for(int c = 0; c < 2; c++){
+      const node& child = nodes[ children[c] ];
+      float grown = perimeter( combine(child.box, leaf_box) );
+      child_cost[c] = grown + inheritance;
+      if( ! nodes[ children[c] ].is_leaf())
+        child_cost[c] -= perimeter(child.box);
+    }
+    
+    if(cost < child_cost[0] && cost < child_cost[1])
+      break;
+    
+    sibling = child_cost[0] < child_cost[1] ? children[0] : children[1];
+  }
+  
+  // new parent
+  int old_parent = nodes[sibling].parent;
+  int new_parent = allocate_node();   // may move 'nodes', only hold indices
+  nodes[new_parent].parent = old_parent;
+  nodes[new_parent].box = combine(nodes[sibling].box, leaf_box);
+  nodes[new_parent].child_0 = sibling;
+  nodes[new_parent].child_1 = leaf;
+  nodes[sibling].parent = new_parent;
+  nodes[leaf].parent = new_parent;
+  
+  if(old_parent == null_node)
+    root = new_parent;
+  else if(nodes[old_parent].child_0 == sibling)
+    nodes[old_parent].child_0 = new_parent;
+  else
+    nodes[old_parent].child_1 = new_parent;
+  
+  refit(old_parent);
+}
+
+
+
+//------------------------------------------------------------------------------
+void AABB_Tree_Broadphase::remove_leaf(int leaf){
+  if(leaf == root){
+    root = null_node;
+    return;
+  }
+  
+  int parent = nodes[leaf].parent;
+  int grand_parent = nodes[parent].parent;
+  int sibling = nodes[parent].child_0 == leaf ? nodes[parent].child_1 : nodes[parent].child_0;
+  
+  // sibling takes the place of parent
+  if(grand_parent == null_node)
+    root = sibling;
+  else if(nodes[grand_parent].child_0 == parent)
+    nodes[grand_parent].child_0 = sibling;
+  else
+    nodes[grand_parent].child_1 = sibling;
+  
+  nodes[sibling].parent = grand_parent;
+  free_node(parent);
+  refit(grand_parent);
+}
+
+
+
+//------------------------------------------------------------------------------
+void AABB_Tree_Broadphase::refit(int n){
+  for( ; n != null_node; n = nodes[n].parent)
+    nodes[n].box = combine(nodes[ nodes[n].child_0 ].box, nodes[ nodes[n].child_1 ].box);
+}
+
+
+
+//------------------------------------------------------------------------------
+void AABB_Tree_Broadphase::query(int leaf, const std::vector< aabb >& boxes, std::vector< body_pair >& pairs){
+  uint i = nodes[leaf].box_index;
+  const aabb& box = boxes[i];
+  
+  stack.clear();
+  stack.push_back(root);
+  
+  while( ! stack.empty()){
+    int n = stack.back();
+    stack.pop_back();
+    
+    if( ! overlap(nodes[n].box, box))
+      continue;
+    
+    if( ! nodes[n].is_leaf()){
+      stack.push_back(nodes[n].child_0);
+      stack.push_back(nodes[n].child_1);
+      continue;
+    }
+    
+    // every pair is seen from both sides, keep one
+    uint j = nodes[n].box_index;
+    if(j > i && overlap(box, boxes[j]))
+      pairs.push_back( {i, j} );
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void AABB_Tree_Broadphase::clear(){
+  nodes.clear();
+  free_nodes.clear();
+  leaves.clear();
+  root = null_node;
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+
+
+struct aabb{
+  glm::vec2 min;
+  glm::vec2 max;
+};
+
+struct body_pair{
+  uint i;   // always i < j, both index into the box array
+  uint j;
+};
+
+enum broadphase_type{
+  bp_brute_force,
+  bp_grid,
+  bp_sweep_prune,
+  bp_aabb_tree
+};
+
+
+
+// finds candidate pairs whose bounding boxes overlap, narrowphase does the rest
+class Broadphase{
+public:
+  virtual ~Broadphase(){}
+  virtual std::string get_name() = 0;
+  virtual void find_pairs(
+    const std::vector< aabb >& boxes,
+    std::vector< body_pair >& pairs   // cleared & sorted by (i, j)
+  ) = 0;
+  static std::shared_ptr< Broadphase > create(broadphase_type type);
+  static bool overlap(const aabb& box_0, const aabb& box_1);
+  
+protected:
+  static void sort_pairs(std::vector< body_pair >& pairs);
+};
+
+
+
+//------------------------------------------------------------------------------
+// every i<j pair, only useful as a reference
+class Brute_Force_Broadphase : public Broadphase{
+public:
+  std::string get_name();
+  void find_pairs(const std::vector< aabb >& boxes, std::vector< body_pair >& pairs);
+};
+
+
+
+//------------------------------------------------------------------------------
+// uniform grid, hashed into one sorted array of (cell, box) entries
+class Grid_Broadphase : public Broadphase{
+public:
+  std::string get_name();
+  void find_pairs(const std::vector< aabb >& boxes, std::vector< body_pair >& pairs);
+  
+private:
+  struct cell_entry{
+    uint64_t cell;
+    uint box;
+  };
+  
+  std::vector< cell_entry > entries;   // kept to reuse its memory
+  float cell_size = 1.0f;
+  
+  float calc_cell_size(const std::vector< aabb >& boxes);
+  int64_t cell_coord(float f);
+  static uint64_t cell_key(int64_t x, int64_t y);
+};
+
+
+
+//------------------------------------------------------------------------------
+// sorted along x, order is kept between ticks so re-sorting is nearly linear
+class Sweep_Prune_Broadphase : public Broadphase{
+public:
+  std::string get_name();
+  void find_pairs(const std::vector< aabb >& boxes, std::vector< body_pair >& pairs);
+  
+private:
+  std::vector< uint > order;
+  
+  void update_order(const std::vector< aabb >& boxes);
+};
+
+
+
+//------------------------------------------------------------------------------
+// dynamic bounding volume tree over fattened boxes, only moved leaves get reinserted
+class AABB_Tree_Broadphase : public Broadphase{
+public:
+  std::string get_name();
+  void find_pairs(const std::vector< aabb >& boxes, std::vector< body_pair >& pairs);
+  
+private:
+  static constexpr int null_node = -1;
+  struct node{
+    aabb box;
+    int parent = null_node;
+    int child_0 = null_node;
+    int child_1 = null_node;
+    int box_index = null_node;   // leaf only
+    bool is_leaf(){  return child_0 == null_node;  }
+  };
+  
+  std::vector< node > nodes;
+  std::vector< int > free_nodes;
+  std::vector< int > leaves;   // leaf node of every box
+  std::vector< int > stack;
+  int root = null_node;
+  float margin_factor = 0.1f;   // fat boxes grow by this much of their size
+  
+  void sync_leaves(const std::vector< aabb >& boxes);
+  aabb fatten(const aabb& box);
+  static bool contains(const aabb& outer, const aabb& inner);
+  static aabb combine(const aabb& box_0, const aabb& box_1);
+  static float perimeter(const aabb& box);
+  int allocate_node();
+  void free_node(int n);
+  void insert_leaf(int leaf);
+  void remove_leaf(int leaf);
+  void refit(int n);
+  void query(int leaf, const std::vector< aabb >& boxes, std::vector< body_pair >& pairs);
+  void clear();
+};
\ No newline at end of file
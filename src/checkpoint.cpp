@@ -0,0 +1,241 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "checkpoint.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <exception>
+
+
+
+void Checkpoint_Out::begin(uint tick){
+  this->tick = tick;
+  data.resize( sizeof(checkpoint_header) );   // filled in by 'finish()'
+}
+
+
+
+//------------------------------------------------------------------------------
+void Checkpoint_Out::finish(){
+  checkpoint_header header = {};
+  std::memcpy(header.magic, magic, sizeof(header.magic));
+  header.endian_marker = endian_marker;
+  header.version = version;
+  header.header_size = sizeof(checkpoint_header);
+  header.tick = tick;
+  header.data_size = data.size() - sizeof(header);
+  
+  std::memcpy(data.data(), &header, sizeof(header));
+}
+
+
+
+//------------------------------------------------------------------------------
+std::vector< char >& Checkpoint_Out::get_data(){  return data;  }
+
+
+
+//------------------------------------------------------------------------------
+void Checkpoint_Out::write_string(const std::string& string){
+  write_array( std::vector< char >(string.begin(), string.end()) );
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// in
+////////////////////////////////////////////////////////////////////////////////
+
+Checkpoint_In::Checkpoint_In(std::span< const char > data){
+  checkpoint_header header;
+  if(data.size() < sizeof(header))
+    throw std::runtime_error("Invalid checkpoint! File too small for header.");
+  std::memcpy(&header, data.data(), sizeof(header));
+  
+  if(std::memcmp(header.magic, Checkpoint_Out::magic, sizeof(header.magic)) != 0)
+    throw std::runtime_error("Invalid checkpoint! Not a checkpoint file.");
+  if(header.endian_marker != Checkpoint_Out::endian_marker)
+    throw std::runtime_error("Invalid checkpoint! Written on a machine with other byte order.");
+  if(header.version != Checkpoint_Out::version){
+    std::stringstream message;
+    message << "Invalid checkpoint! Version " << header.version << " is not supported (expected " << Checkpoint_Out::version << ").";
+    throw std::runtime_error(message.str());
+  }
+  if(header.header_size != sizeof(checkpoint_header) || header.data_size != data.size() - sizeof(header))
+    throw std::runtime_error("Invalid checkpoint! Header or file size does not match, maybe cut off.");
+  
+  this->data = data;
+  pos = sizeof(header);
+  tick = header.tick;
+}
+
+
+
+//------------------------------------------------------------------------------
+uint Checkpoint_In::get_tick(){  return tick;  }
+
+
+
+//------------------------------------------------------------------------------
+bool Checkpoint_In::done(){  return pos == data.size();  }
+
+
+
+//------------------------------------------------------------------------------
+std::string Checkpoint_In::read_string(){
+  std::vector< char > chars;
+  read_array(chars);
+  
+  return std::string(chars.begin(), chars.end());
+}
+
+
+
+//------------------------------------------------------------------------------
+void Checkpoint_In::check_left(std::size_t size){
+  if(size > data.size() - pos)
+    throw std::runtime_error("Invalid checkpoint! Data reaches past end of file.");
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// writer
+////////////////////////////////////////////////////////////////////////////////
+
+Checkpoint_Writer::Checkpoint_Writer(){
+  thread = std::thread(&Checkpoint_Writer::work, this);
+}
+
+
+
+//------------------------------------------------------------------------------
+Checkpoint_Writer::~Checkpoint_Writer(){
+  finish();
+}
+
+
+
+//------------------------------------------------------------------------------
+void Checkpoint_Writer::finish(){
+  if( ! thread.joinable())
+    return;
+  
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  signal.notify_one();
+  thread.join();
+}
+
+
+
+//------------------------------------------------------------------------------
+void Checkpoint_Writer::write(const std::string& file_name, std::vector< char >& data){
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(has_pending)
+      dropped_count++;   // disk is slower than checkpoints come in, the newer one wins
+    
+    pending_file_name = file_name;
+    std::swap(pending, data);
+    has_pending = true;
+  }
+  signal.notify_one();
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Checkpoint_Writer::get_written_count(){
+  std::lock_guard<std::mutex> lock(mutex);
+  return written_count;
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Checkpoint_Writer::get_dropped_count(){
+  std::lock_guard<std::mutex> lock(mutex);
+  return dropped_count;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Checkpoint_Writer::work(){
+  std::vector< char > writing;
+  std::string file_name;
+  
+  while(true){
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      signal.wait(lock, [this](){  return has_pending || stopping;  });
+      if( ! has_pending)
+        return;   // stopping, nothing left
+      
+      std::swap(writing, pending);   // 'pending' gets the old buffer, handed back with the next 'write()'
+      file_name = pending_file_name;
+      has_pending = false;
+    }
+    
+    bool written = write_file(file_name, writing);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    written_count += written ? 1 : 0;
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Checkpoint_Writer::write_file(const std::string& file_name, const std::vector< char >& data){
+  // write aside & rename, a crash while writing keeps the previous checkpoint
+  std::string tmp_name = file_name + ".tmp";
+  
+  try{
+    std::ofstream file(tmp_name, std::ios::binary | std::ios::trunc);
+    if( ! file)
+      throw std::runtime_error("Unable to open file '" + tmp_name + "' for writing!");
+    file.write(data.data(), data.size());
+    file.close();
+    if( ! file)
+      throw std::runtime_error("Unable to write file '" + tmp_name + "'!");
+    
+    std::filesystem::rename(tmp_name, file_name);
+  }
+  catch(std::exception& e){
+    // no one to throw to on this thread, the simulation goes on
+    std::cerr << "Warning: Checkpoint not written: " << e.what() << "\n";
+    return false;
+  }
+  
+  return true;
+}
\ No newline at end of file
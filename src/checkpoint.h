@@ -0,0 +1,159 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <span>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+
+
+
+// checkpoint file, version 1:
+//   header | state of 'Scene' & its parts, each writes & reads its own in the same order
+// all numbers in the byte order of the machine that wrote it, anything else is rejected
+struct checkpoint_header{
+  char magic[8];   // "2DPHYCKP"
+  uint32_t endian_marker;   // 0x01020304
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t tick;   // ticks passed when it was taken
+  uint64_t data_size;   // after the header
+};
+
+
+
+// serialises into memory, cheap enough for the tick thread (see 'Checkpoint_Writer' for the file)
+class Checkpoint_Out{
+public:
+  static constexpr char magic[8] = {'2', 'D', 'P', 'H', 'Y', 'C', 'K', 'P'};
+  static constexpr uint32_t endian_marker = 0x01020304;
+  static constexpr uint32_t version = 1;   // bump whenever anything writes more, less or in another order
+  
+  void begin(uint tick);   // drops what was written before, keeps the memory
+  void finish();   // fills in the header
+  std::vector< char >& get_data();
+  void write_string(const std::string& string);
+  
+  template< typename T >
+  void write_value(const T& value){
+    static_assert(std::is_trivially_copyable_v< T >);
+    std::size_t size = data.size();
+    data.resize(size + sizeof(T));
+    std::memcpy(data.data() + size, &value, sizeof(T));
+  }
+  
+  template< typename T >
+  void write_array(const std::vector< T >& values){
+    static_assert(std::is_trivially_copyable_v< T >);
+    write_value< uint64_t >( values.size() );
+    std::size_t size = data.size();
+    data.resize(size + values.size() * sizeof(T));
+    std::memcpy(data.data() + size, values.data(), values.size() * sizeof(T));
+  }
+  
+private:
+  std::vector< char > data;
+  uint tick = 0;
+};
+
+
+
+//------------------------------------------------------------------------------
+// reads what 'Checkpoint_Out' wrote, throws instead of reading past the end
+class Checkpoint_In{
+public:
+  Checkpoint_In(std::span< const char > data);   // checks the header
+  uint get_tick();
+  bool done();   // everything read
+  std::string read_string();
+  
+  template< typename T >
+  T read_value(){
+    static_assert(std::is_trivially_copyable_v< T >);
+    check_left( sizeof(T) );
+    T value;
+    std::memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+  }
+  
+  template< typename T >
+  void read_array(std::vector< T >& values){
+    static_assert(std::is_trivially_copyable_v< T >);
+    uint64_t count = read_value< uint64_t >();
+    if(count > (data.size() - pos) / sizeof(T))
+      throw std::runtime_error("Invalid checkpoint! Array reaches past end of file.");
+    values.resize(count);
+    std::memcpy(values.data(), data.data() + pos, count * sizeof(T));
+    pos += count * sizeof(T);
+  }
+  
+private:
+  std::span< const char > data;
+  std::size_t pos = 0;
+  uint tick = 0;
+  
+  void check_left(std::size_t size);
+};
+
+
+
+//------------------------------------------------------------------------------
+// writes checkpoints on its own thread, so the ticks never wait for the disk.
+// only the newest one counts: one still waiting when the next arrives is dropped
+class Checkpoint_Writer{
+public:
+  Checkpoint_Writer();
+  ~Checkpoint_Writer();   // see 'finish()'
+  Checkpoint_Writer(const Checkpoint_Writer&) = delete;
+  Checkpoint_Writer& operator=(const Checkpoint_Writer&) = delete;
+  void write(const std::string& file_name, std::vector< char >& data);   // swaps 'data' with a buffer done with
+  void finish();   // writes what's still waiting, no more 'write()' after it
+  std::size_t get_written_count();
+  std::size_t get_dropped_count();
+  
+private:
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable signal;
+  std::string pending_file_name;
+  std::vector< char > pending;
+  bool has_pending = false;
+  bool stopping = false;
+  std::size_t written_count = 0;
+  std::size_t dropped_count = 0;
+  
+  void work();
+  static bool write_file(const std::string& file_name, const std::vector< char >& data);
+};
\ No newline at end of file
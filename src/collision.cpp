@@ -28,44 +28,67 @@ SOFTWARE.
 
 #include <iostream>
 #include <vector>
+#include <limits>
+#include <algorithm>
+#include <math.h>
 
 
 
-Collision::Collision(std::shared_ptr< PhyObject > phy_obj_0, std::shared_ptr< PhyObject > phy_obj_1)
-  : Collision(phy_obj_0, phy_obj_1, std::numeric_limits<id>::max()){}
+Collision::Collision(Body_Store& bodies)
+  : bodies(bodies){}
 
 
 
 //------------------------------------------------------------------------------
-Collision::Collision(std::shared_ptr< PhyObject > phy_obj_0, std::shared_ptr< PhyObject > phy_obj_1, id window_id){
-  this->phy_obj_0 = phy_obj_0;
-  this->phy_obj_1 = phy_obj_1;
-  this->window_id = window_id;
-  
-  this->visible = true;
-  contact = check_contact();
-}
+Collision::~Collision(){}
 
 
 
 //------------------------------------------------------------------------------
-Collision::~Collision(){
-  if(visible && ! Window::got_closed(window_id))
-    Window::remove_gobject(window_id, collision_marker);
+void Collision::detect(std::span< const body_pair > pairs, Contact_Buffer& contacts){
+  // approximate (big distance -> no collision)
+  near_pairs.clear();
+  polygon_pairs.clear();
+  for(auto &p : pairs){
+    body_0 = p.i;
+    body_1 = p.j;
+    if( ! check_distance())
+      continue;
+    
+    near_pairs.push_back(p);
+    if( ! bodies.is_circle(p.i) && ! bodies.is_circle(p.j))
+      polygon_pairs.push_back(p);
+  }
+  
+  // polygons: check in more detail, all at once
+  sat.overlap_batch(bodies, polygon_pairs, overlaps);
+  
+  // contacts, in pair order
+  std::size_t polygon_k = 0;
+  for(auto &p : near_pairs){
+    body_0 = p.i;
+    body_1 = p.j;
+    
+    contact& c = contacts.add();
+    c.body_0 = body_0;
+    c.body_1 = body_1;
+    
+    bool touching;
+    if(bodies.is_circle(body_0) || bodies.is_circle(body_1))
+      touching = detect_circle(c);
+    else if( (touching = overlaps[polygon_k++]) )
+      fetch_collision_variables(c);
+    
+    if( ! touching)
+      contacts.pop();
+  }
 }
 
 
 
 //------------------------------------------------------------------------------
-bool Collision::has_contact(){  return contact;  }
-
-
-
-//------------------------------------------------------------------------------
-void Collision::handle(){
-  if( ! contact) return;   // skip if there is no contact
-
-  apply_impulse();
+std::string Collision::get_sat_isa_name(){
+  return Sat_Kernel::get_isa_name( sat.get_isa() );
 }
 
 
@@ -74,168 +97,175 @@ void Collision::handle(){
 // private
 ////////////////////////////////////////////////////////////////////////////////
 
-bool Collision::check_contact(){  
-  // approximate (big distance -> no collision)
-  float max_distance = phy_obj_0->get_size() + phy_obj_1->get_size();
-  float distance = glm::distance(phy_obj_0->get_position(), phy_obj_1->get_position());
+bool Collision::check_distance(){
+  float max_distance = bodies.get_shape(body_0).size + bodies.get_shape(body_1).size;
+  float distance = glm::distance(bodies.position[body_0], bodies.position[body_1]);
   
-  if(distance > max_distance)
-    return false;
-    
-  // check in more detail
-  return check_contact_detailed();
+  return distance <= max_distance;
 }
 
 
 
 //------------------------------------------------------------------------------
-bool Collision::check_contact_detailed(){
-  auto points_0 = fetch_points_world_space(phy_obj_0);
-  auto points_1 = fetch_points_world_space(phy_obj_1);
-  auto edges = fetch_edges(points_0, points_1);
-  
-  bool overlap;
-  for(auto &e : edges){
-    glm::vec2 edge_vector = e.p_0 - e.p_1;
-    glm::vec2 axis = perpendicular(edge_vector);
-    overlap = check_proj_overlap(
-      project_polygon(axis, points_0),
-      project_polygon(axis, points_1)
-    );
-    
-    if( ! overlap)   // found separating line
-      return false;
+bool Collision::detect_circle(contact& c){
+  bool touching;
+  
+  // normal always points from body_0 to body_1
+  if(bodies.is_circle(body_0) && bodies.is_circle(body_1))
+    touching = circle_circle(c);
+  else if(bodies.is_circle(body_0))
+    touching = circle_polygon(body_0, body_1, c);
+  else{
+    touching = circle_polygon(body_1, body_0, c);
+    c.coll_normal = - c.coll_normal;
   }
   
-  return true;   // no separating line found
+  return touching;
 }
 
 
 
 //------------------------------------------------------------------------------
-Collision::projection Collision::project_polygon(glm::vec2 axis, std::vector< glm::vec2 > polygon){
-  if(polygon.size() < 1)
-    throw std::runtime_error("Collision detection: Cannot check polygon with zero points.");
+bool Collision::circle_circle(contact& c){
+  float radius_0 = bodies.get_shape(body_0).radius;
+  float radius_1 = bodies.get_shape(body_1).radius;
+  glm::vec2 diff = bodies.position[body_1] - bodies.position[body_0];
+  float distance_sq = glm::dot(diff, diff);
+  float max_distance = radius_0 + radius_1;
+  
+  if(distance_sq >= max_distance * max_distance)
+    return false;
   
-  float min, max;
-  min = max = glm::dot(axis, polygon[0]);
+  // centers on top of each other -> any direction will do
+  float distance = sqrt(distance_sq);
+  c.coll_normal = distance > 0.0f ? diff / distance : glm::vec2(1.0f, 0.0f);
   
-  // project point onto axis and compare to prev min/max
-  for(std::size_t i = 1; i < polygon.size(); i++){
-    float proj = glm::dot(axis, polygon[i]);
-    
-    if(proj < min)
-      min = proj;
-      
-    if(proj > max)
-      max = proj;
-  }
+  // middle of the overlap
+  float depth = max_distance - distance;
+  c.depth = depth;
+  c.coll_point = bodies.position[body_0] + c.coll_normal * (radius_0 - depth * 0.5f);
   
-  return {min, max};
+  return true;
 }
 
 
 
 //------------------------------------------------------------------------------
-bool Collision::check_proj_overlap(Collision::projection proj_0, Collision::projection proj_1){
-  if(proj_0.min < proj_1.min)
-    return proj_1.min < proj_0.max;   // min0 ----- min1 -- max0 ----- max1
+bool Collision::circle_polygon(std::size_t circle, std::size_t polygon, contact& c){
+  glm::vec2 center = bodies.position[circle];
+  float radius = bodies.get_shape(circle).radius;
+  auto points = bodies.get_world_points(polygon);
+  
+  // nearest point on outline & whether center is inside (same side of every edge)
+  float min_distance_sq = std::numeric_limits<float>::max();
+  glm::vec2 nearest;
+  glm::vec2 nearest_edge;
+  int side_pos = 0;
+  int side_neg = 0;
+  
+  glm::vec2 prev_point = points.back();
+  for(auto &p : points){
+    glm::vec2 edge = p - prev_point;
+    glm::vec2 to_center = center - prev_point;
+    float side = edge.x * to_center.y - edge.y * to_center.x;
+    side > 0.0f ? side_pos++ : side_neg++;
     
-  return proj_0.min < proj_1.max;   // min1 ----- min0 -- max1 ----- max0
-}
-
-
-
-//------------------------------------------------------------------------------
-glm::vec2 Collision::perpendicular(glm::vec2 vec){
-  return glm::normalize( glm::vec2( - vec.y, vec.x) );
-}
-
-
-
-//------------------------------------------------------------------------------
-void Collision::apply_impulse(){
-  ref_pos = phy_obj_0->get_position();
-  ref_rot = phy_obj_0->get_rotation();
-  
-  float impulse = calc_impulse();
-  
-  phy_obj_0->apply_impulse(impulse, rel_coll_point_0, coll_normal);
-  phy_obj_1->apply_impulse( - impulse, rel_coll_point_1, coll_normal);
-}
-
-
-
-//------------------------------------------------------------------------------
-float Collision::calc_impulse(){
-  fetch_collision_variables();
-  float bounciness = ( phy_obj_0->get_bounciness() + phy_obj_1->get_bounciness() ) / 2;
-  
-  // formular:
-  //                                - ( 1 + c ) * dot(v_rel, n)
-  // __________________________________________________________________________________
-  // (1 / m_a) + (1 / m_b) + ( (cross(x_a, n))^2 ) / I_a + ( (cross(x_b, n))^2 ) / I_b
-  //
-  
-  float numerator = -( 1.0f + bounciness ) * glm::dot(impact_velocity, coll_normal);
-  float denominator = (1.0f / phy_obj_0->get_mass());
-  
-  denominator += (1.0f / phy_obj_1->get_mass());
+    float t = glm::dot(to_center, edge) / glm::dot(edge, edge);
+    t = std::max(0.0f, std::min(1.0f, t));
+    glm::vec2 point = prev_point + edge * t;
+    float distance_sq = glm::dot(center - point, center - point);
+    
+    if(distance_sq < min_distance_sq){
+      min_distance_sq = distance_sq;
+      nearest = point;
+      nearest_edge = edge;
+    }
+    
+    prev_point = p;
+  }
   
-  float tmp = cross_2d(rel_coll_point_0, coll_normal);
-  tmp *= tmp;
-  tmp /= phy_obj_0->get_inertia_tensor();
+  bool inside = side_pos == 0 || side_neg == 0;
+  float distance = sqrt(min_distance_sq);
   
-  denominator += tmp;
+  if( ! inside && distance >= radius)
+    return false;
   
-  tmp = cross_2d(rel_coll_point_1, coll_normal);
-  tmp *= tmp;
-  tmp /= phy_obj_1->get_inertia_tensor();
+  // center outside: push apart along the line to the nearest point
+  if( ! inside){
+    c.coll_normal = (nearest - center) / distance;
+    c.depth = radius - distance;
+    c.coll_point = (center + c.coll_normal * radius + nearest) * 0.5f;
+    return true;
+  }
   
-  denominator += tmp;
+  // center inside: leave through the nearest edge
+  glm::vec2 outward = glm::normalize( glm::vec2( - nearest_edge.y, nearest_edge.x) );
+  if(glm::dot(outward, nearest - bodies.position[polygon]) < 0.0f)
+    outward = - outward;
   
-  return numerator / denominator;
+  c.coll_normal = - outward;
+  c.depth = radius + distance;
+  c.coll_point = nearest;
+  return true;
 }
 
 
 
 //------------------------------------------------------------------------------
-void Collision::fetch_collision_variables(){
-  // convert all points into object_space of first phy_object
-  auto points_0 = phy_obj_0->get_points();
-  auto points_1 = fetch_points_world_space(phy_obj_1);
+void Collision::fetch_collision_variables(contact& c){
+  ref_pos = bodies.position[body_0];
+  ref_rot = bodies.rotation[body_0];
+  
+  // convert all points into object_space of first body
+  const auto& local_points_0 = bodies.get_shape(body_0).points;
+  auto world_points_1 = bodies.get_world_points(body_1);
+  points_1.assign(world_points_1.begin(), world_points_1.end());   // reuses capacity
   to_object_space(points_1, ref_pos, ref_rot);
   
-  // collision point (world & object space)
-  coll_point = approximate_coll_point(points_0, points_1);
-  rel_coll_point_0 = coll_point;
-  rel_coll_point_1 = coll_point;
-  to_object_space(rel_coll_point_0, ref_pos, ref_rot);
-  to_object_space(rel_coll_point_1, phy_obj_1->get_position(), phy_obj_1->get_rotation());
+  // collision point (world space)
+  c.coll_point = approximate_coll_point(local_points_0, points_1);
   
-  // impact vectors
-  coll_normal = glm::normalize(coll_point - ref_pos);   // rough approximation
-  impact_velocity = calc_impact_velocity();
+  // impact vector
+  calc_penetration(c);
 }
 
 
 
 //------------------------------------------------------------------------------
-glm::vec2 Collision::calc_impact_velocity(){  
-  // linear velocity
-  glm::vec2 rel_vel_1 = phy_obj_1->get_velocity();
-  glm::vec2 rel_vel_0 = phy_obj_0->get_velocity();
-  
-  // angular velocity
-  glm::vec3 ang_vel_0 = { 0.0f, 0.0f, phy_obj_0->get_angular_velocity() };
-  glm::vec3 ang_vel_1 = { 0.0f, 0.0f, phy_obj_1->get_angular_velocity() };
-  ang_vel_0 = glm::cross( ang_vel_0, {rel_coll_point_0, 0.0f} );
-  ang_vel_1 = glm::cross( ang_vel_1, {rel_coll_point_1, 0.0f} );
+void Collision::calc_penetration(contact& c){
+  auto points_0 = bodies.get_world_points(body_0);
+  auto points_1 = bodies.get_world_points(body_1);
+  auto axes_0 = bodies.get_world_axes(body_0);
+  auto axes_1 = bodies.get_world_axes(body_1);
+  c.depth = std::numeric_limits<float>::max();
+  
+  // axis of least overlap, pushing apart along it is the shortest way out
+  for(auto axes : {axes_0, axes_1}){
+    for(auto &a : axes){
+      float min_0 = std::numeric_limits<float>::max();
+      float max_0 = std::numeric_limits<float>::lowest();
+      float min_1 = min_0;
+      float max_1 = max_0;
+      for(auto &p : points_0){
+        min_0 = std::min(min_0, glm::dot(p, a));
+        max_0 = std::max(max_0, glm::dot(p, a));
+      }
+      for(auto &p : points_1){
+        min_1 = std::min(min_1, glm::dot(p, a));
+        max_1 = std::max(max_1, glm::dot(p, a));
+      }
+      
+      float overlap = std::min(max_0, max_1) - std::max(min_0, min_1);
+      if(overlap < c.depth){
+        c.depth = overlap;
+        c.coll_normal = a;
+      }
+    }
+  }
   
-  // result
-  rel_vel_0 += glm::vec2( ang_vel_0.x, ang_vel_0.y );
-  rel_vel_1 += glm::vec2( ang_vel_1.x, ang_vel_1.y );
-  return rel_vel_0 - rel_vel_1;
+  // normal always points from body_0 to body_1
+  if(glm::dot(c.coll_normal, bodies.position[body_1] - bodies.position[body_0]) < 0.0f)
+    c.coll_normal = - c.coll_normal;
 }
 
 
@@ -243,7 +273,7 @@ glm::vec2 Collision::calc_impact_velocity(){
 //------------------------------------------------------------------------------
 glm::vec2 Collision::approximate_coll_point(const std::vector< glm::vec2 >& points_0, const std::vector< glm::vec2 >& points_1){
   glm::vec2 center_0 = {0.0f, 0.0f};
-  glm::vec2 center_1 = phy_obj_1->get_position();
+  glm::vec2 center_1 = bodies.position[body_1];
   to_object_space(center_1, ref_pos, ref_rot);
   
   auto approx_p0 = approx_rel_coll_point(points_0, center_1);
@@ -253,12 +283,7 @@ glm::vec2 Collision::approximate_coll_point(const std::vector< glm::vec2 >& poin
   to_world_space(approx_p1, ref_pos, ref_rot);
   
   // result
-  glm::vec2 result = (approx_p0 + approx_p1) * 0.5f;
-  
-  if(visible)
-    collision_marker = Window::add_gobject(window_id, t_circle, {result, 0.0f}, 3.0f, {1.0f, 1.0f, 1.0f});
-  
-  return result;
+  return (approx_p0 + approx_p1) * 0.5f;
 }
 
 
@@ -312,44 +337,6 @@ glm::vec2 Collision::refine_nearest_point(glm::vec2 curr_point, glm::vec2 neighb
 
 
 
-//------------------------------------------------------------------------------
-std::vector< glm::vec2 > Collision::fetch_points_world_space(std::shared_ptr< PhyObject > phy_obj){
-  auto points = phy_obj->get_points();
-  auto position = phy_obj->get_position();
-  auto rotation = phy_obj->get_rotation();
-  
-  to_world_space(points, position, rotation);
-  
-  return points;
-}
-
-
-
-//------------------------------------------------------------------------------
-std::vector< Collision::edge > Collision::fetch_edges(const std::vector< glm::vec2 >& points_0, const std::vector< glm::vec2 >& points_1){
-  std::vector< edge > ret;
-  
-  // polygon 0
-  glm::vec2 prev_point = points_0.back();
-  
-  for(auto &p : points_0){
-    ret.push_back( {prev_point, p} );
-    prev_point = p;
-  }
-  
-  // polygon 1
-  prev_point = points_1.back();
-  
-  for(auto &p : points_1){
-    ret.push_back( {prev_point, p} );
-    prev_point = p;
-  }
-  
-  return ret;
-}
-
-
-
 //------------------------------------------------------------------------------
 void Collision::to_world_space(std::vector< glm::vec2 >& points, glm::vec2 offset, float rotation){
   // adjust to rotation
@@ -426,13 +413,4 @@ void Collision::to_object_space(glm::vec2& point, glm::vec2 offset, float rotati
   float y = -(point.x * sine) + point.y * cosine;
   point.x = x;
   point.y = y;
-}
-
-
-
-//------------------------------------------------------------------------------
-float Collision::cross_2d(glm::vec2 v_0, glm::vec2 v_1){
-  return v_0.x * v_1.y - v_0.y - v_1.x;
-}
-
-
+}
\ No newline at end of file
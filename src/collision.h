@@ -26,64 +26,49 @@ SOFTWARE.
 
 #pragma once
 
-#include <memory>
+#include <vector>
+#include <span>
 
 #include <glm/glm.hpp>
 
-#include "phy_object.h"
+#include "body_store.h"
+#include "contact.h"
+#include "broadphase.h"
+#include "sat_kernel.h"
 
 
 
+// narrowphase, one instance is reused for every pair
 class Collision{
 public:
-  Collision(
-    std::shared_ptr< PhyObject > phy_obj_0,
-    std::shared_ptr< PhyObject > phy_obj_1
-  );
-  Collision(
-    std::shared_ptr< PhyObject > phy_obj_0,
-    std::shared_ptr< PhyObject > phy_obj_1,
-    id window_id
-  );
+  Collision(Body_Store& bodies);
   ~Collision();
-  bool has_contact();
-  void handle();
+  void detect(
+    std::span< const body_pair > pairs,   // dense indices into 'bodies'
+    Contact_Buffer& contacts   // gets one contact per touching pair, in pair order
+  );
+  std::string get_sat_isa_name();
   
 protected:
-  struct edge{
-    glm::vec2 p_0;
-    glm::vec2 p_1;
-  };
-  struct projection{
-    float min;
-    float max;
-  };
-  
-  bool contact = false;
-  std::shared_ptr< PhyObject > phy_obj_0;
-  std::shared_ptr< PhyObject > phy_obj_1;
-  bool visible = false;
-  id window_id;
-  id collision_marker;
+  Body_Store& bodies;
+  Sat_Kernel sat;
+  std::size_t body_0;
+  std::size_t body_1;
   glm::vec2 ref_pos;
   float ref_rot;
-  glm::vec2 coll_point;
-  glm::vec2 rel_coll_point_0;
-  glm::vec2 rel_coll_point_1;
-  glm::vec2 coll_normal;
-  glm::vec2 impact_velocity;
   
-  bool check_contact();
-  bool check_contact_detailed();
-  projection project_polygon(
-    glm::vec2 axis,
-    std::vector< glm::vec2 > polygon
-  );
-  bool check_proj_overlap(projection proj_0, projection proj_1);
-  glm::vec2 perpendicular(glm::vec2 vec);
-  void apply_impulse();
-  float calc_impulse();
-  void fetch_collision_variables();
+  // scratch space, only grows -> no allocations once warmed up
+  std::vector< glm::vec2 > points_1;
+  std::vector< body_pair > near_pairs;
+  std::vector< body_pair > polygon_pairs;
+  std::vector< uint8_t > overlaps;
+  
+  bool check_distance();
+  bool detect_circle(contact& c);
+  bool circle_circle(contact& c);
+  bool circle_polygon(std::size_t circle, std::size_t polygon, contact& c);
+  void fetch_collision_variables(contact& c);
+  void calc_penetration(contact& c);
   glm::vec2 approximate_coll_point(
     const std::vector< glm::vec2 >& points_0,
     const std::vector< glm::vec2 >& points_1
@@ -99,14 +84,6 @@ protected:
     glm::vec2 target,
     int max_depth
   );
-  glm::vec2 calc_impact_velocity();
-  std::vector< glm::vec2 > fetch_points_world_space(   // does the compiler really optimise return by value for std types?
-    std::shared_ptr< PhyObject > phy_obj
-  );
-  std::vector< edge > fetch_edges(   // does the compiler really optimise return by value for std types?
-    const std::vector< glm::vec2 >& points_0,
-    const std::vector< glm::vec2 >& points_1
-  );
   static void to_world_space(
     std::vector< glm::vec2 >& points,
     glm::vec2 offset,
@@ -127,5 +104,4 @@ protected:
     glm::vec2 offset,
     float rotation
   );
-  static float cross_2d(glm::vec2 v_0, glm::vec2 v_1);
 };
\ No newline at end of file
@@ -0,0 +1,283 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "compiled_scene.h"
+
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+#include "scene.h"
+#include "phy_object.h"
+
+
+
+void Compiled_Scene::set_name(const std::string& name){
+  this->name = name;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Compiled_Scene::set_background_colour(glm::vec3 colour){
+  background = colour;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Compiled_Scene::set_time(uint time){
+  this->time = time;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Compiled_Scene::set_broadphase(broadphase_type type){
+  broadphase = type;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Compiled_Scene::add_object(glm::vec2 pos, float rot, float size, glm::vec3 colour, uint time, phy_obj_type type){
+  // the expensive part, done once per scene file instead of once per run
+  std::shared_ptr<PhyObject> obj = PhyObject::create(type, pos, rot, size, colour, time);
+  prepared_object p = obj->prepare( add_shape(obj->get_body_shape()) );
+  
+  objects.push_back({
+    (uint32_t) p.type,
+    {p.position.x, p.position.y},
+    p.rotation,
+    p.size,
+    {p.colour.x, p.colour.y, p.colour.z},
+    p.time,
+    p.mass,
+    p.inertia_tensor,
+    p.bounciness,
+    p.shape
+  });
+}
+
+
+
+//------------------------------------------------------------------------------
+std::vector< char > Compiled_Scene::serialise(uint64_t source_hash, uint64_t source_size){
+  // same tick -> file order, same as 'Spawn_Schedule'
+  std::stable_sort(objects.begin(), objects.end(), [](auto& o_0, auto& o_1){  return o_0.time < o_1.time;  });
+  
+  auto align = [](uint64_t offset){  return (offset + 7) / 8 * 8;  };
+  
+  compiled_scene_header header = {};
+  std::memcpy(header.magic, magic, sizeof(header.magic));
+  header.endian_marker = endian_marker;
+  header.version = version;
+  header.header_size = sizeof(compiled_scene_header);
+  header.shape_size = sizeof(compiled_shape_record);
+  header.object_size = sizeof(compiled_object_record);
+  header.time = time;
+  header.broadphase = broadphase;
+  header.background[0] = background.x;
+  header.background[1] = background.y;
+  header.background[2] = background.z;
+  header.name_length = name.size();
+  header.shape_count = shapes.size();
+  header.point_count = points.size();
+  header.source_hash = source_hash;
+  header.source_size = source_size;
+  header.object_count = objects.size();
+  header.shape_offset = align(sizeof(header) + name.size());
+  header.point_offset = align(header.shape_offset + shapes.size() * sizeof(compiled_shape_record));
+  header.object_offset = align(header.point_offset + points.size() * sizeof(glm::vec2));
+  
+  // one block, padding stays zero
+  std::vector< char > data(header.object_offset + objects.size() * sizeof(compiled_object_record), 0);
+  std::memcpy(data.data(), &header, sizeof(header));
+  std::memcpy(data.data() + sizeof(header), name.data(), name.size());
+  std::memcpy(data.data() + header.shape_offset, shapes.data(), shapes.size() * sizeof(compiled_shape_record));
+  std::memcpy(data.data() + header.point_offset, points.data(), points.size() * sizeof(glm::vec2));
+  std::memcpy(data.data() + header.object_offset, objects.data(), objects.size() * sizeof(compiled_object_record));
+  
+  return data;
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Compiled_Scene::is_compiled(std::span< const char > data, uint64_t source_hash, uint64_t source_size){
+  try{
+    compiled_scene_header header = read_header(data);
+    return header.source_hash == source_hash && header.source_size == source_size;
+  }
+  catch(std::exception&){
+    return false;
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Compiled_Scene::load(std::span< const char > data, Scene& scene){
+  // everything is checked before the scene gets anything, a broken file must not leave half a scene
+  compiled_scene_header header = read_header(data);
+  
+  // shapes
+  std::vector< body_shape > shapes(header.shape_count);
+  for(uint32_t s = 0; s < header.shape_count; s++){
+    compiled_shape_record r;
+    std::memcpy(&r, data.data() + header.shape_offset + s * sizeof(r), sizeof(r));
+    if(
+      r.type > circle ||
+      (uint64_t) r.point_begin + r.point_count > header.point_count ||
+      (uint64_t) r.axis_begin + r.axis_count > header.point_count
+    )
+      throw std::runtime_error("Invalid compiled scene! Broken shape.");
+    
+    body_shape& shape = shapes[s];
+    shape = {(phy_obj_type) r.type, r.size, {}, {}, {r.center_of_mass[0], r.center_of_mass[1]}, r.bounding_radius, r.radius};
+    const char* point_data = data.data() + header.point_offset;
+    shape.points.resize(r.point_count);
+    shape.axes.resize(r.axis_count);
+    std::memcpy(shape.points.data(), point_data + r.point_begin * sizeof(glm::vec2), r.point_count * sizeof(glm::vec2));
+    std::memcpy(shape.axes.data(), point_data + r.axis_begin * sizeof(glm::vec2), r.axis_count * sizeof(glm::vec2));
+  }
+  
+  // objects
+  const char* object_data = data.data() + header.object_offset;
+  for(uint64_t i = 0; i < header.object_count; i++){
+    compiled_object_record r;
+    std::memcpy(&r, object_data + i * sizeof(r), sizeof(r));
+    if(r.type > circle || r.shape >= header.shape_count){
+      std::stringstream message;
+      message << "Invalid compiled scene! Broken object record " << i << ".";
+      throw std::runtime_error(message.str());
+    }
+  }
+  
+  // all fine, now the scene
+  scene.set_name( std::string(data.data() + header.header_size, header.name_length) );
+  scene.set_background_colour( {header.background[0], header.background[1], header.background[2]} );
+  scene.set_time(header.time);
+  scene.set_broadphase( (broadphase_type) header.broadphase );
+  
+  std::vector< shape_id > shape_ids(header.shape_count);   // compiled index -> 'Body_Store' id
+  for(uint32_t s = 0; s < header.shape_count; s++)
+    shape_ids[s] = scene.add_shape(shapes[s]);
+  
+  // objects, straight from the mapping
+  for(uint64_t i = 0; i < header.object_count; i++){
+    compiled_object_record r;
+    std::memcpy(&r, object_data + i * sizeof(r), sizeof(r));
+    scene.add_prepared_object({
+      (phy_obj_type) r.type,
+      {r.position[0], r.position[1]},
+      r.rotation,
+      r.size,
+      {r.colour[0], r.colour[1], r.colour[2]},
+      r.time,
+      r.mass,
+      r.inertia_tensor,
+      r.bounciness,
+      shape_ids[r.shape]
+    });
+  }
+  
+  return header.object_count;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t Compiled_Scene::add_shape(const body_shape& shape){
+  auto key = std::make_pair( (int) shape.type, shape.size );
+  auto found = shape_lookup.find(key);
+  if(found != shape_lookup.end())
+    return found->second;
+  
+  compiled_shape_record r = {
+    (uint32_t) shape.type,
+    shape.size,
+    {shape.center_of_mass.x, shape.center_of_mass.y},
+    shape.bounding_radius,
+    shape.radius,
+    (uint32_t) points.size(),
+    (uint32_t) shape.points.size(),
+    (uint32_t) (points.size() + shape.points.size()),
+    (uint32_t) shape.axes.size()
+  };
+  points.insert(points.end(), shape.points.begin(), shape.points.end());
+  points.insert(points.end(), shape.axes.begin(), shape.axes.end());
+  
+  uint32_t s = shapes.size();
+  shapes.push_back(r);
+  shape_lookup[key] = s;
+  
+  return s;
+}
+
+
+
+//------------------------------------------------------------------------------
+compiled_scene_header Compiled_Scene::read_header(std::span< const char > data){
+  compiled_scene_header header;
+  if(data.size() < sizeof(header))
+    throw std::runtime_error("Invalid compiled scene! File too small for header.");
+  std::memcpy(&header, data.data(), sizeof(header));
+  
+  if(std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.endian_marker != endian_marker)
+    throw std::runtime_error("Invalid compiled scene! Not a compiled scene of this machine.");
+  if(header.version != version){
+    std::stringstream message;
+    message << "Invalid compiled scene! Version " << header.version << " is not supported (expected " << version << ").";
+    throw std::runtime_error(message.str());
+  }
+  if(
+    header.header_size != sizeof(compiled_scene_header) ||
+    header.shape_size != sizeof(compiled_shape_record) ||
+    header.object_size != sizeof(compiled_object_record)
+  )
+    throw std::runtime_error("Invalid compiled scene! Header or record size does not match.");
+  if(header.broadphase > bp_aabb_tree)
+    throw std::runtime_error("Invalid compiled scene! Unknown broadphase.");
+  
+  // every block in order & inside the file
+  uint64_t size = data.size();
+  if(
+    (uint64_t) header.header_size + header.name_length > header.shape_offset ||
+    header.shape_offset + (uint64_t) header.shape_count * sizeof(compiled_shape_record) > header.point_offset ||
+    header.point_offset + (uint64_t) header.point_count * sizeof(glm::vec2) > header.object_offset ||
+    header.object_offset > size ||
+    header.object_count > (size - header.object_offset) / sizeof(compiled_object_record)
+  )
+    throw std::runtime_error("Invalid compiled scene! Data reaches past end of file.");
+  
+  return header;
+}
\ No newline at end of file
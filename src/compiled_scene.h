@@ -0,0 +1,137 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+#include <span>
+#include <utility>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "scene_target.h"
+#include "body_store.h"
+
+class Scene;
+
+
+
+// compiled scene, version 1 (see 'Scene_Cache'):
+//   header | name (not terminated) | padding to 8 bytes | shapes | points | objects
+// objects are fully prepared (mass, inertia, shape), so loading one constructs no 'PhyObject'.
+// only ever read on the machine that wrote it -> native byte order, anything else is rejected
+struct compiled_scene_header{
+  char magic[8];   // "2DPHYCMP"
+  uint32_t endian_marker;   // 0x01020304
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t shape_size;
+  uint32_t object_size;
+  uint32_t time;
+  uint32_t broadphase;   // 'broadphase_type'
+  float background[3];
+  uint32_t name_length;
+  uint32_t shape_count;
+  uint32_t point_count;   // points & axes of every shape, back to back
+  uint32_t reserved;
+  uint64_t source_hash;   // of the scene file this was compiled from
+  uint64_t source_size;
+  uint64_t object_count;
+  uint64_t shape_offset;   // from start of file, each 8 byte aligned
+  uint64_t point_offset;
+  uint64_t object_offset;
+};
+
+
+
+struct compiled_shape_record{   // see 'body_shape'
+  uint32_t type;   // 'phy_obj_type'
+  float size;
+  float center_of_mass[2];
+  float bounding_radius;
+  float radius;
+  uint32_t point_begin;   // into the points
+  uint32_t point_count;
+  uint32_t axis_begin;
+  uint32_t axis_count;
+};
+
+
+
+struct compiled_object_record{   // see 'prepared_object'
+  uint32_t type;   // 'phy_obj_type'
+  float position[2];
+  float rotation;
+  float size;
+  float colour[3];
+  uint32_t time;
+  float mass;
+  float inertia_tensor;
+  float bounciness;
+  uint32_t shape;   // into the shapes
+};
+
+
+
+// prepares the objects of a parsed scene once, so they can be stored & loaded without doing it again
+class Compiled_Scene : public Scene_Target{
+public:
+  static constexpr char magic[8] = {'2', 'D', 'P', 'H', 'Y', 'C', 'M', 'P'};
+  static constexpr uint32_t endian_marker = 0x01020304;
+  static constexpr uint32_t version = 1;   // bump whenever 'PhyObject' prepares objects differently
+  
+  void set_name(const std::string& name);
+  void set_background_colour(glm::vec3 colour);
+  void set_time(uint time);
+  void set_broadphase(broadphase_type type);
+  void add_object(
+    glm::vec2 position,
+    float rotation,
+    float size,
+    glm::vec3 colour,
+    uint time,
+    phy_obj_type type
+  );
+  std::vector< char > serialise(uint64_t source_hash, uint64_t source_size);
+  static bool is_compiled(std::span< const char > data, uint64_t source_hash, uint64_t source_size);   // valid header for this source
+  static std::size_t load(std::span< const char > data, Scene& scene);   // returns object count, leaves 'scene' alone if anything is broken
+  
+private:
+  std::string name;
+  glm::vec3 background = {0.0f, 0.0f, 0.0f};
+  uint time = 0;
+  broadphase_type broadphase = bp_sweep_prune;   // same default as 'Scene'
+  std::vector< compiled_shape_record > shapes;
+  std::vector< glm::vec2 > points;
+  std::vector< compiled_object_record > objects;
+  std::map< std::pair< int, float >, uint32_t > shape_lookup;   // (type, size) -> shape, same as 'Body_Store'
+  
+  uint32_t add_shape(const body_shape& shape);
+  static compiled_scene_header read_header(std::span< const char > data);
+};
\ No newline at end of file
@@ -0,0 +1,74 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "contact.h"
+
+
+
+void Contact_Buffer::reset(){  count = 0;  }
+
+
+
+//------------------------------------------------------------------------------
+contact& Contact_Buffer::add(){
+  if(count == contacts.size())
+    contacts.push_back( contact() );   // only grows, never shrinks
+  
+  return contacts[count++];
+}
+
+
+
+//------------------------------------------------------------------------------
+void Contact_Buffer::pop(){  count--;  }
+
+
+
+//------------------------------------------------------------------------------
+void Contact_Buffer::append(Contact_Buffer& other){
+  for(auto &c : other)
+    add() = c;
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Contact_Buffer::size(){  return count;  }
+
+
+
+//------------------------------------------------------------------------------
+contact& Contact_Buffer::operator[](std::size_t i){  return contacts[i];  }
+
+
+
+//------------------------------------------------------------------------------
+std::vector< contact >::iterator Contact_Buffer::begin(){  return contacts.begin();  }
+
+
+
+//------------------------------------------------------------------------------
+std::vector< contact >::iterator Contact_Buffer::end(){  return contacts.begin() + count;  }
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+
+
+struct contact{   // plain record, filled by narrowphase & consumed by 'Contact_Solver'
+  std::size_t body_0;   // dense indices into 'Body_Store'
+  std::size_t body_1;
+  glm::vec2 coll_point;   // world space
+  glm::vec2 coll_normal;   // unit length, body_0 -> body_1
+  float depth;   // penetration along 'coll_normal'
+};
+
+
+
+// reset every tick, memory is kept so a steady-state tick does not allocate
+class Contact_Buffer{
+public:
+  void reset();
+  contact& add();
+  void pop();
+  void append(Contact_Buffer& other);
+  std::size_t size();
+  contact& operator[](std::size_t i);
+  std::vector< contact >::iterator begin();
+  std::vector< contact >::iterator end();
+  
+private:
+  std::vector< contact > contacts;
+  std::size_t count = 0;
+};
\ No newline at end of file
@@ -0,0 +1,246 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "contact_solver.h"
+
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+
+
+
+Contact_Solver::Contact_Solver(Body_Store& bodies)
+  : bodies(bodies){}
+
+
+
+//------------------------------------------------------------------------------
+void Contact_Solver::set_iterations(uint iterations){
+  if(iterations < 1)
+    throw std::runtime_error("Solver needs at least 1 iteration.");
+  
+  this->iterations = iterations;
+}
+
+
+
+//------------------------------------------------------------------------------
+uint Contact_Solver::get_iterations(){  return iterations;  }
+
+
+
+//------------------------------------------------------------------------------
+void Contact_Solver::solve(Contact_Buffer& contacts, float step_time){
+  prepare(contacts, step_time);
+  warm_start();
+  
+  // contacts in order -> same result every run
+  for(uint i = 0; i < iterations; i++)
+    for(auto &sc : solver_contacts)
+      solve_contact(sc);
+  
+  store_impulses();
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Contact_Solver::get_warm_started(){  return warm_started;  }
+
+
+
+//------------------------------------------------------------------------------
+void Contact_Solver::save(Checkpoint_Out& out){
+  out.write_value(iterations);
+  
+  std::vector< uint64_t > keys;
+  std::vector< float > values;
+  for(auto &[key, impulse] : impulses){
+    keys.push_back(key);
+    values.push_back(impulse);
+  }
+  out.write_array(keys);
+  out.write_array(values);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Contact_Solver::load(Checkpoint_In& in){
+  // a setting from the command line, the results only match with the same one
+  uint saved_iterations = in.read_value< uint >();
+  if(saved_iterations != iterations)
+    throw std::runtime_error(
+      "Checkpoint was taken with " + std::to_string(saved_iterations) + " solver iteration(s), not "
+      + std::to_string(iterations) + ". Resume with '--iterations " + std::to_string(saved_iterations) + "'."
+    );
+  
+  std::vector< uint64_t > keys;
+  std::vector< float > values;
+  in.read_array(keys);
+  in.read_array(values);
+  if(keys.size() != values.size())
+    throw std::runtime_error("Invalid checkpoint! Solver impulses don't match.");
+  
+  impulses.clear();
+  for(std::size_t k = 0; k < keys.size(); k++)
+    impulses.push_back( {keys[k], values[k]} );
+  sort_impulses(impulses);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////////////
+
+void Contact_Solver::prepare(Contact_Buffer& contacts, float step_time){
+  solver_contacts.resize( contacts.size() );   // only grows in capacity
+  
+  for(std::size_t k = 0; k < contacts.size(); k++){
+    const contact& c = contacts[k];
+    solver_contact& sc = solver_contacts[k];
+    sc.body_0 = c.body_0;
+    sc.body_1 = c.body_1;
+    sc.arm_0 = c.coll_point - bodies.position[c.body_0];
+    sc.arm_1 = c.coll_point - bodies.position[c.body_1];
+    sc.normal = c.coll_normal;
+    sc.impulse = 0.0f;
+    
+    // formular:
+    //                                            1
+    // ___________________________________________________________________________
+    // (1 / m_a) + (1 / m_b) + (cross(r_a, n))^2 / I_a + (cross(r_b, n))^2 / I_b
+    //
+    float arm_normal_0 = cross_2d(sc.arm_0, sc.normal);
+    float arm_normal_1 = cross_2d(sc.arm_1, sc.normal);
+    float inverse_mass =
+      1.0f / bodies.mass[c.body_0] +
+      1.0f / bodies.mass[c.body_1] +
+      arm_normal_0 * arm_normal_0 / bodies.inertia_tensor[c.body_0] +
+      arm_normal_1 * arm_normal_1 / bodies.inertia_tensor[c.body_1];
+    sc.normal_mass = 1.0f / inverse_mass;
+    
+    // bounce off (from velocity before solving) or push out of each other, whichever is stronger
+    float bounciness = ( bodies.bounciness[c.body_0] + bodies.bounciness[c.body_1] ) / 2;
+    float normal_velocity = relative_normal_velocity(sc);
+    float bounce = normal_velocity < - restitution_threshold ? - bounciness * normal_velocity : 0.0f;
+    float push_out = position_correction / step_time * std::max(c.depth - allowed_penetration, 0.0f);
+    sc.bias = std::max(bounce, push_out);
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Contact_Solver::warm_start(){
+  warm_started = 0;
+  
+  for(auto &sc : solver_contacts){
+    uint64_t key = pair_key(sc.body_0, sc.body_1);
+    auto it = std::lower_bound(impulses.begin(), impulses.end(), key, [](const std::pair< uint64_t, float >& p, uint64_t key){
+      return p.first < key;
+    });
+    if(it == impulses.end() || it->first != key)
+      continue;
+    
+    sc.impulse = it->second;
+    bodies.apply_impulse(sc.body_0, - sc.impulse * sc.normal, sc.arm_0);
+    bodies.apply_impulse(sc.body_1, sc.impulse * sc.normal, sc.arm_1);
+    warm_started++;
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Contact_Solver::solve_contact(solver_contact& sc){
+  float delta = sc.normal_mass * (sc.bias - relative_normal_velocity(sc));
+  
+  // accumulated impulse may only push, the single step may pull back what was too much
+  float old_impulse = sc.impulse;
+  sc.impulse = std::max(old_impulse + delta, 0.0f);
+  delta = sc.impulse - old_impulse;
+  
+  bodies.apply_impulse(sc.body_0, - delta * sc.normal, sc.arm_0);
+  bodies.apply_impulse(sc.body_1, delta * sc.normal, sc.arm_1);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Contact_Solver::store_impulses(){
+  next_impulses.clear();   // keeps its capacity
+  for(auto &sc : solver_contacts)
+    next_impulses.push_back( {pair_key(sc.body_0, sc.body_1), sc.impulse} );
+  sort_impulses(next_impulses);
+  
+  std::swap(impulses, next_impulses);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Contact_Solver::sort_impulses(std::vector< std::pair< uint64_t, float > >& impulses){
+  // in place, 'std::stable_sort()' would allocate every tick
+  std::sort(impulses.begin(), impulses.end(), [](auto& p_0, auto& p_1){
+    return p_0.first < p_1.first;
+  });
+  
+  // one contact per pair, keys repeat only in a broken checkpoint
+  impulses.erase( std::unique(impulses.begin(), impulses.end(), [](auto& p_0, auto& p_1){
+    return p_0.first == p_1.first;
+  }), impulses.end() );
+}
+
+
+
+//------------------------------------------------------------------------------
+float Contact_Solver::relative_normal_velocity(const solver_contact& sc){
+  glm::vec2 velocity_0 = bodies.get_point_velocity(sc.body_0, sc.arm_0);
+  glm::vec2 velocity_1 = bodies.get_point_velocity(sc.body_1, sc.arm_1);
+  
+  return glm::dot(velocity_1 - velocity_0, sc.normal);   // < 0 -> approaching
+}
+
+
+
+//------------------------------------------------------------------------------
+uint64_t Contact_Solver::pair_key(std::size_t body_0, std::size_t body_1){
+  // body ids, a key doesn't depend on where the bodies are stored
+  uint64_t id_0 = bodies.ids[body_0];
+  uint64_t id_1 = bodies.ids[body_1];
+  
+  return std::min(id_0, id_1) << 32 | std::max(id_0, id_1);
+}
+
+
+
+//------------------------------------------------------------------------------
+float Contact_Solver::cross_2d(glm::vec2 v_0, glm::vec2 v_1){
+  return v_0.x * v_1.y - v_0.y * v_1.x;
+}
\ No newline at end of file
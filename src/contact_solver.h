@@ -0,0 +1,82 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "body_store.h"
+#include "contact.h"
+
+
+
+// sequential impulses: every contact is solved several times per tick,
+// the accumulated impulse is clamped (contacts only push) & carried over to the next tick
+class Contact_Solver{
+public:
+  Contact_Solver(Body_Store& bodies);
+  void set_iterations(uint iterations);
+  uint get_iterations();
+  void solve(Contact_Buffer& contacts, float step_time);
+  std::size_t get_warm_started();   // contacts of the last 'solve()' that already existed the tick before
+  void save(Checkpoint_Out& out);   // accumulated impulses for the next tick
+  void load(Checkpoint_In& in);   // throws if it was saved with other iterations
+  
+private:
+  struct solver_contact{
+    std::size_t body_0;
+    std::size_t body_1;
+    glm::vec2 arm_0;   // world space, center of mass -> contact point
+    glm::vec2 arm_1;
+    glm::vec2 normal;   // body_0 -> body_1
+    float normal_mass;   // 1 / effective mass along normal
+    float bias;   // target separating velocity
+    float impulse;   // accumulated
+  };
+  
+  Body_Store& bodies;
+  uint iterations = 10;
+  float position_correction = 0.2f;   // share of the penetration removed per tick
+  float allowed_penetration = 0.5f;   // below this, contacts stay resting instead of jittering
+  float restitution_threshold = 1.0f;   // slower impacts don't bounce
+  std::vector< solver_contact > solver_contacts;
+  std::vector< std::pair< uint64_t, float > > impulses;   // body id pair -> accumulated impulse of last tick, sorted by key
+  std::vector< std::pair< uint64_t, float > > next_impulses;   // both only grow in capacity, no allocation per tick
+  std::size_t warm_started = 0;
+  
+  void prepare(Contact_Buffer& contacts, float step_time);
+  void warm_start();
+  void solve_contact(solver_contact& sc);
+  void store_impulses();
+  static void sort_impulses(std::vector< std::pair< uint64_t, float > >& impulses);
+  float relative_normal_velocity(const solver_contact& sc);
+  uint64_t pair_key(std::size_t body_0, std::size_t body_1);
+  static float cross_2d(glm::vec2 v_0, glm::vec2 v_1);
+};
\ No newline at end of file
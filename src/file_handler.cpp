@@ -28,55 +28,264 @@ SOFTWARE.
 
 #include <iostream>
 #include <sstream>
+#include <charconv>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 
 
-void File_Handler::process(const std::string& file_name, std::shared_ptr<Scene> scene){
+
+void File_Handler::set_threads(uint thread_count){
+  if(thread_count < 1)
+    throw std::runtime_error("File_Handler needs at least one thread.");
+  
+  // the same pool serves every file
+  if(threads ? threads->get_thread_count() == thread_count : thread_count == 1)
+    return;
+  
+  threads.reset();
+  if(thread_count > 1)
+    threads = std::make_shared< Thread_Pool >(thread_count);
+}
+
+
+
+//------------------------------------------------------------------------------
+bool File_Handler::process(const std::string& file_name, std::shared_ptr<Scene_Target> scene){
+  this->file_name = file_name;
   this->scene = scene;
-  file_pos = 0;
-  line = 1;
-  load_file_content(file_name);
+  stream_done = true;
+  
+  bool ok = load_file_content();
+  this->scene.reset();
+  file.reset();
+  return ok;
+}
+
+
+
+//------------------------------------------------------------------------------
+bool File_Handler::stream(const std::string& file_name, std::shared_ptr<Scene_Target> scene){
+  this->file_name = file_name;
+  this->scene = scene;   // for the settings, objects go to whoever calls 'load_until()'
+  
+  if( ! open_file())
+    return false;
+  
+  try{
+    binary = Binary_Scene::is_binary(*file);
+    if(binary){
+      binary_info = Binary_Scene::load_header(*file, *scene);
+      next_record = 0;
+    }
+    else{
+      check_char('{');
+      parse_scene();
+      begin_object_array();
+    }
+    
+    stream_done = false;
+    pending.time = 0;
+    stream_next_object();
+  }
+  catch(std::exception& e){
+    std::cerr << "Error: Unable to parse file '" + file_name + "'!\n" + e.what() + "\n";
+    this->scene.reset();
+    return false;
+  }
+  
+  this->scene.reset();   // the scene will hold on to this handler, not the other way round
+  return true;
+}
+
+
+
+//------------------------------------------------------------------------------
+void File_Handler::convert(const std::string& file_name, const std::string& binary_file_name){
+  auto writer = std::make_shared< Binary_Scene_Writer >();
+  if( ! process(file_name, writer))
+    return;
+  
+  writer->write(binary_file_name);
+  std::cout << "Converted '" << file_name << "' to '" << binary_file_name << "' (" << writer->get_object_count() << " objects).\n";
+}
+
+
+
+//------------------------------------------------------------------------------
+void File_Handler::benchmark(const std::string& file_name){
+  Mapped_File mapped(file_name);
+  if(Binary_Scene::is_binary(mapped)){
+    std::cout << "Skipping '" << file_name << "', the parser benchmark needs a text scene file.\n";
+    return;
+  }
+  
+  double megabytes = mapped.size() / 1e6;
+  std::cout << "Parser benchmark '" << file_name << "' (" << megabytes << " MB), best of 3:\n";
+  
+  // best of a few runs, in seconds
+  auto measure = [](auto function){
+    double best = 1e30;
+    for(int run = 0; run < 3; run++){
+      auto time_start = std::chrono::steady_clock::now();
+      function();
+      best = std::min(best, std::chrono::duration< double >(std::chrono::steady_clock::now() - time_start).count());
+    }
+    return std::max(best, 1e-9);
+  };
+  
+  for(scan_isa isa : {scan_scalar, scan_sse, scan_avx2}){
+    if(isa > Structural_Index::detect_isa())
+      break;
+    
+    // pre-scan alone, same chunks as the parser uses
+    Structural_Index scan(isa);
+    std::size_t tokens = 0;
+    double scan_seconds = measure([&](){
+      tokens = 0;
+      bool in_token = false;
+      for(const char* c = mapped.begin(); c < mapped.end(); c += index_chunk_size){
+        const char* end = std::min(c + index_chunk_size, mapped.end());
+        scan.build(c, end, in_token);
+        tokens += scan.get_positions().size();
+        in_token = valid_char(end[-1]) && ! Structural_Index::is_structural(end[-1]);
+      }
+    });
+    
+    // whole parse, pre-scan included
+    std::size_t objects = 0;
+    index.set_isa(isa);
+    double parse_seconds = measure([&](){
+      auto writer = std::make_shared< Binary_Scene_Writer >();
+      if(process(file_name, writer))
+        objects = writer->get_object_count();
+    });
+    
+    std::cout
+      << "  " << Structural_Index::get_isa_name(isa) << ": "
+      << "pre-scan " << megabytes / scan_seconds << " MB/s (" << tokens << " tokens), "
+      << "parse " << megabytes / parse_seconds << " MB/s (" << objects << " objects)\n";
+  }
+  
+  index.set_isa( Structural_Index::detect_isa() );
+}
+
+
+
+//------------------------------------------------------------------------------
+void File_Handler::load_until(uint tick, Scene_Target& target){
+  while( ! stream_done && pending.time <= tick){
+    target.add_object(pending.position, pending.rotation, pending.size, pending.colour, pending.time, pending.type);
+    stream_next_object();
+  }
+  
+  // what has been read won't be needed again
+  if( ! binary && ! stream_done)
+    file->release(file_pos);
 }
 
 
 
+//------------------------------------------------------------------------------
+bool File_Handler::done(){  return stream_done;  }
+
+
+
+//------------------------------------------------------------------------------
+uint File_Handler::get_next_tick(){  return pending.time;  }
+
+
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // private
 ////////////////////////////////////////////////////////////////////////////////
 
-void File_Handler::load_file_content(const std::string& file_name){
-  // open file
-  std::ifstream file;
-  file.exceptions(std::ios::failbit | std::ios::badbit);   // without this, no exception will be thrown when ".open()" fails
-  try{  file.open(file_name);  }
+bool File_Handler::load_file_content(){
+  if( ! open_file())
+    return false;
+  
+  // try parsing it
+  try{
+    if(Binary_Scene::is_binary(*file))
+      Binary_Scene::load(*file, *scene);
+    else
+      parse_file();
+  }
   catch(std::exception& e){
-    std::cerr << "Error: Unable to open file '" + file_name + "'!\n";
-    return;
+    std::cerr << "Error: Unable to parse file '" + file_name + "'!\n" + e.what() + "\n";
+    return false;
   }
   
-  // get file content
-  file_content = std::string(
-    (std::istreambuf_iterator<char>(file)),
-    (std::istreambuf_iterator<char>())
-  );
+  return true;
+}
+
+
+
+//------------------------------------------------------------------------------
+bool File_Handler::open_file(){
+  // map file, no copy
+  try{  file = std::make_unique< Mapped_File >(file_name);  }
+  catch(std::exception& e){
+    std::cerr << "Error: " << e.what() << "\n";
+    return false;
+  }
   
-  // try parsing it
-  try{  parse_file();  }
+  file_start = file_pos = file->begin();
+  file_stop = file->end();
+  line_pos = file_start;
+  line = 1;
+  index_begin = index_end = file_start;   // nothing scanned yet
+  index_cursor = 0;
+  return true;
+}
+
+
+
+//------------------------------------------------------------------------------
+void File_Handler::stream_next_object(){
+  uint prev_time = pending.time;
+  
+  try{
+    if(binary){
+      stream_done = next_record >= binary_info.object_count;
+      if( ! stream_done)
+        pending = Binary_Scene::load_object(*file, binary_info, next_record++);
+    }
+    else{
+      stream_done = ! next_object(pending);
+      if(stream_done)
+        check_char('}');
+    }
+    
+    // spawn order is what makes streaming work
+    if( ! stream_done && pending.time < prev_time){
+      std::stringstream message;
+      message << "Objects have to be ordered by 'time' for streaming ('--convert' sorts them), found " << pending.time << " after " << prev_time;
+      if( ! binary)
+        message << " in line " << current_line();
+      message << ".";
+      throw std::runtime_error(message.str());
+    }
+  }
   catch(std::exception& e){
-    std::cerr << "Error: Unable to parse file '" + file_name + "'!\n" + e.what() + "\n";
-    return;
+    stream_done = true;
+    file.reset();
+    throw std::runtime_error("Unable to stream file '" + file_name + "'! " + e.what());
   }
+  
+  if(stream_done)
+    file.reset();   // nothing left to read
 }
 
 
 
 //------------------------------------------------------------------------------
 void File_Handler::parse_file(){
-  file_content += ".";
-  
   check_char('{');  
   parse_scene();
+  parse_object_array();
   check_char('}');
 }
 
@@ -93,9 +302,11 @@ void File_Handler::parse_scene(){
     
   check_string("time");
   parse_time();
+  
+  if( optional_check_string("broadphase") )   // optional
+    parse_broadphase();
     
   check_string("objects");
-  parse_object_array();
 }
 
 
@@ -113,8 +324,8 @@ void File_Handler::parse_scene_name(){
 void File_Handler::parse_background(){
   check_char(':');
   
-  std::vector<float> colour = parse_float_array();
-  if(colour.size() != 3)
+  float colour[4];
+  if(parse_float_array(colour) != 3)
     throw std::runtime_error("Invalid value for scene background colour.");
   
   scene->set_background_colour( glm::vec3(colour[0], colour[1], colour[2]) );
@@ -134,25 +345,190 @@ void File_Handler::parse_time(){
 
 
 //------------------------------------------------------------------------------
-void File_Handler::parse_object_array(){
+void File_Handler::parse_broadphase(){
   check_char(':');
-  check_char('[');
+  std::string name = next_string();
+  
+  if(name == "brute-force")
+    scene->set_broadphase(bp_brute_force);
+  else if(name == "grid")
+    scene->set_broadphase(bp_grid);
+  else if(name == "sweep-prune")
+    scene->set_broadphase(bp_sweep_prune);
+  else if(name == "aabb-tree")
+    scene->set_broadphase(bp_aabb_tree);
+    
+  else{
+    std::stringstream message;
+    message << "Invalid file format! Expected 'brute-force', 'grid', 'sweep-prune' or 'aabb-tree' in line " << current_line() << ".";
+    throw std::runtime_error(message.str());
+  }
+  
+  check_char(',');
+}
+
+
+
+//------------------------------------------------------------------------------
+void File_Handler::parse_object_array(){
+  begin_object_array();
+  
+  if(threads && parse_object_array_parallel())
+    return;
+  
+  object_description obj;
+  while(next_object(obj))
+    scene->add_object(obj.position, obj.rotation, obj.size, obj.colour, obj.time, obj.type);
+}
+
+
+
+//------------------------------------------------------------------------------
+bool File_Handler::parse_object_array_parallel(){
+  // split at object boundaries, several chunks per thread for balance
+  const char* array_begin = file_pos;
+  std::size_t chunk_count = std::min< std::size_t >(threads->get_thread_count() * 4, (file_stop - array_begin) / min_chunk_size);
+  
+  std::vector< const char* > chunk_begins = {array_begin};
+  for(std::size_t k = 1; k < chunk_count; k++){
+    const char* boundary = find_object_boundary( array_begin + (file_stop - array_begin) * k / chunk_count );
+    if(boundary == nullptr)
+      break;
+    if(boundary > chunk_begins.back())
+      chunk_begins.push_back(boundary);
+  }
+  if(chunk_begins.size() < 2)
+    return false;
+  
+  // every chunk gets its own parser, all share the mapping
+  struct chunk_result{
+    std::vector< object_description > objects;
+    const char* end;
+    bool ok = true;
+  };
+  std::vector< chunk_result > results( chunk_begins.size() );
+  
+  threads->run(chunk_begins.size(), [&](std::size_t k){
+    bool last = k + 1 == chunk_begins.size();
+    File_Handler parser;
+    parser.init_chunk_parser(*this, chunk_begins[k], last ? file_stop : chunk_begins[k + 1] - 1);   // without the ',' in between
+    
+    try{
+      parser.parse_object_chunk(last, results[k].objects);
+      results[k].end = parser.file_pos;
+    }
+    catch(std::exception&){
+      results[k].ok = false;
+    }
+  });
+  
+  // error -> parse it again one by one, so the message is exactly what it would be single threaded
+  for(auto &r : results)
+    if( ! r.ok)
+      return false;
+  
+  // merge in file order
+  for(auto &r : results)
+    for(auto &obj : r.objects)
+      scene->add_object(obj.position, obj.rotation, obj.size, obj.colour, obj.time, obj.type);
+  
+  file_pos = results.back().end;
+  first_object = false;
+  return true;
+}
+
+
+
+//------------------------------------------------------------------------------
+const char* File_Handler::find_object_boundary(const char* from){
+  // objects hold no '}' of their own, so '}' ',' '"' can only be the gap between two of them
+  for(const char* c = from; c < file_stop; c++){
+    c = (const char*) memchr(c, '}', file_stop - c);
+    if(c == nullptr)
+      return nullptr;
+    
+    const char* next = c + 1;
+    for( ; next < file_stop && ! valid_char(*next); next++);
+    if(next == file_stop || *next != ',')
+      continue;
+    
+    const char* comma = next;
+    for(next++; next < file_stop && ! valid_char(*next); next++);
+    if(next < file_stop && *next == '"')
+      return comma + 1;
+  }
+  
+  return nullptr;
+}
+
+
 
-  if(optional_check_char(']'))
-    return;   // empty array
+//------------------------------------------------------------------------------
+void File_Handler::init_chunk_parser(File_Handler& parent, const char* begin, const char* end){
+  file_start = parent.file_start;   // line numbers stay global
+  file_pos = begin;
+  file_stop = end;
+  line_pos = file_start;
+  line = 1;
+  index.set_isa( parent.index.get_isa() );
+  index_begin = index_end = begin;
+  index_cursor = 0;
+}
+
+
+
+//------------------------------------------------------------------------------
+void File_Handler::parse_object_chunk(bool last, std::vector< object_description >& objects){
+  objects.push_back( parse_object() );
   
-  parse_object();
+  // last chunk ends with the array
+  if(last){
+    first_object = false;
+    object_description obj;
+    while(next_object(obj))
+      objects.push_back(obj);
+    return;
+  }
   
-  while( ! optional_check_char(']') && ! file_end()){
+  // others end right before the ',' to the next chunk
+  while(peek_char() != '\0'){
+    check_char(',');
+    objects.push_back( parse_object() );
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void File_Handler::begin_object_array(){
+  check_char(':');
+  check_char('[');
+  first_object = true;
+}
+
+
+
+//------------------------------------------------------------------------------
+bool File_Handler::next_object(object_description& obj){
+  if(first_object){
+    first_object = false;
+    if(optional_check_char(']'))
+      return false;   // empty array
+  }
+  else{
+    if(optional_check_char(']') || file_end())
+      return false;
     check_char(',');
-    parse_object();
   }
+  
+  obj = parse_object();
+  return true;
 }
 
 
 
 //------------------------------------------------------------------------------
-void File_Handler::parse_object(){
+object_description File_Handler::parse_object(){
   phy_obj_type type = parse_object_type();
   
   check_char(':');
@@ -175,7 +551,7 @@ void File_Handler::parse_object(){
   
   check_char('}');
   
-  scene->add_object(pos, rot, size, colour, time, type);
+  return {pos, rot, size, colour, time, type};
 }
 
 
@@ -191,7 +567,7 @@ phy_obj_type File_Handler::parse_object_type(){
     
   else{
     std::stringstream message;
-    message << "Invalid file format! Expected 'triangle', 'rectangle' or 'circle' in line " << line << ".";
+    message << "Invalid file format! Expected 'triangle', 'rectangle' or 'circle' in line " << current_line() << ".";
     throw std::runtime_error(message.str());
   }
 }
@@ -202,10 +578,10 @@ phy_obj_type File_Handler::parse_object_type(){
 glm::vec2 File_Handler::parse_object_position(){
   check_char(':');
   
-  std::vector<float> pos = parse_float_array();
-  if(pos.size() != 2){
+  float pos[4];
+  if(parse_float_array(pos) != 2){
     std::stringstream message;
-    message << "Invalid file format! Expected <[float, float]> after '\"position\":' in line " << line << ".";
+    message << "Invalid file format! Expected <[float, float]> after '\"position\":' in line " << current_line() << ".";
     throw std::runtime_error(message.str());
   }
 
@@ -241,10 +617,10 @@ float File_Handler::parse_object_size(){
 glm::vec3 File_Handler::parse_object_colour(){
   check_char(':');
   
-  std::vector<float> colour = parse_float_array();
-  if(colour.size() != 3){
+  float colour[4];
+  if(parse_float_array(colour) != 3){
     std::stringstream message;
-    message << "Invalid file format! Expected <[float, float, float]> after '\"color\":' in line " << line << ".";
+    message << "Invalid file format! Expected <[float, float, float]> after '\"color\":' in line " << current_line() << ".";
     throw std::runtime_error(message.str());
   }
 
@@ -263,52 +639,107 @@ uint File_Handler::parse_object_time(){
 
 
 //------------------------------------------------------------------------------
-std::vector<float> File_Handler::parse_float_array(){
+std::size_t File_Handler::parse_float_array(std::span< float > values){
   check_char('[');
-  std::vector<float> ret;
+  std::size_t count = 0;
   
-  ret.push_back( next_float() );
-  while( ! optional_check_char(']') && ! file_end()){
+  while(true){
+    float value = next_float();
+    if(count < values.size())   // anything beyond is only counted, callers complain about the size
+      values[count] = value;
+    count++;
+    
+    if(optional_check_char(']') || file_end())
+      return count;
     check_char(',');
-    ret.push_back( next_float() );
   }
-  
-  return ret;
 }
 
 
 
 //------------------------------------------------------------------------------
 char File_Handler::next_char(){
+  skip_invalid_chars();
+  
   // end of file
-  file_pos++;
   if( file_end() )
-    return file_content.at( (file_pos--) - 1 );
+    return '\0';
   
-  // get next valid char
-  char next = file_content.at(file_pos - 1);
-  if(next == '\n')   // this should be 'translated' to be platform independend (?)
-    line++;
-    
-  if( ! valid_char(next))
-    return next_char();
-        
-  return next;
+  return *(file_pos++);
 }
 
 
 
 //------------------------------------------------------------------------------
-char File_Handler::next_num(){
-  char c = next_char();
+char File_Handler::peek_char(){
+  skip_invalid_chars();
   
-  if( ! isdigit(c) && c != '.' && c != '-' ){
-    std::stringstream message;
-    message << "Invalid file format! Expected <number> but found '" << c << "' in line " << line << ".";
-    throw std::runtime_error(message.str());
+  return file_end() ? '\0' : *file_pos;
+}
+
+
+
+//------------------------------------------------------------------------------
+void File_Handler::skip_invalid_chars(){
+  if(file_end() || valid_char(*file_pos))
+    return;
+  
+  // back before the indexed chunk (look ahead), rare -> char by char
+  if(file_pos < index_begin){
+    for( ; ! file_end() && ! valid_char(*file_pos); file_pos++);
+    return;
   }
   
-  return c;
+  // jump straight to the next token the pre-scan found
+  while(file_pos >= index_end){
+    if(index_end >= file_stop){
+      file_pos = file_stop;
+      return;
+    }
+    scan_chunk(file_pos);
+  }
+  
+  auto positions = index.get_positions();
+  while(index_cursor > 0 && index_begin + positions[index_cursor - 1] >= file_pos)
+    index_cursor--;
+  while(index_cursor < positions.size() && index_begin + positions[index_cursor] < file_pos)
+    index_cursor++;
+  
+  if(index_cursor < positions.size()){
+    file_pos = index_begin + positions[index_cursor];
+    return;
+  }
+  
+  // only whitespace left in this chunk
+  file_pos = index_end;
+  skip_invalid_chars();
+}
+
+
+
+//------------------------------------------------------------------------------
+void File_Handler::scan_chunk(const char* begin){
+  index_begin = begin;
+  index_end = begin + std::min< std::size_t >(file_stop - begin, index_chunk_size);
+  index_cursor = 0;
+  
+  bool in_token = begin > file_start && valid_char(begin[-1]) && ! Structural_Index::is_structural(begin[-1]);
+  index.build(index_begin, index_end, in_token);
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t File_Handler::current_line(){
+  // counted on demand (error messages only), from where it was counted last
+  if(file_pos < line_pos){
+    line_pos = file_start;
+    line = 1;
+  }
+  
+  line += std::count(line_pos, file_pos, '\n');   // this should be 'translated' to be platform independend (?)
+  line_pos = file_pos;
+  return line;
 }
 
 
@@ -326,23 +757,37 @@ std::string File_Handler::next_string(){
 
 
 
+//------------------------------------------------------------------------------
+bool File_Handler::match_string(const std::string& string){
+  check_char('"');
+  
+  // compare in place, no copy
+  std::size_t matched = 0;
+  bool equal = true;
+  for(char c = next_char(); c != '"' && c != '\0'; c = next_char()){
+    equal = equal && matched < string.size() && c == string[matched];
+    matched++;
+  }
+  
+  return equal && matched == string.size();
+}
+
+
+
 //------------------------------------------------------------------------------
 float File_Handler::next_float(){
-  // get substring
-  std::string tmp = "";
-  float ret = 0.0f;
-  while( ! optional_check_char('f') && tmp.size() < 20 && ! file_end())
-    tmp += next_num();
+  skip_invalid_chars();
   
-  // handle invalid input
-  try{  ret = std::stof(tmp);  }
-  catch(std::exception& e){
+  // parse in place, has to end with 'f'
+  float ret = 0.0f;
+  auto [end, error] = std::from_chars(file_pos, file_stop, ret);
+  if(error != std::errc() || end == file_stop || *end != 'f'){
     std::stringstream message;
-    message << "Invalid file format! Expected <float> but found '" << tmp << "' in line " << line << ".";
+    message << "Invalid file format! Expected <float> but found '" << next_token() << "' in line " << current_line() << ".";
     throw std::runtime_error(message.str());
   }
   
-  // result
+  file_pos = end + 1;
   return ret;
 }
 
@@ -350,33 +795,41 @@ float File_Handler::next_float(){
 
 //------------------------------------------------------------------------------
 uint File_Handler::next_uint(){
-  // get substring
-  std::string tmp = "";
-  uint ret = 0;
-  while( ! optional_check_char(',') && ! optional_check_char('}') && ! optional_check_char(']') && ! optional_check_char('.') && tmp.size() < 20 && ! file_end())
-    tmp += next_num();
+  skip_invalid_chars();
   
-  // handle invalid input
-  try{  ret = std::stoul(tmp);  }
-  catch(std::exception& e){
+  // parse in place
+  uint ret = 0;
+  auto [end, error] = std::from_chars(file_pos, file_stop, ret);
+  if(error != std::errc()){
     std::stringstream message;
-    message << "Invalid file format! Expected <uint> but found '" << tmp << "' in line " << line << ".";
+    message << "Invalid file format! Expected <uint> but found '" << next_token() << "' in line " << current_line() << ".";
     throw std::runtime_error(message.str());
   }
   
-  // result
-  file_pos--;   // revert from optional_check
+  file_pos = end;
   return ret;
 }
 
 
 
+//------------------------------------------------------------------------------
+std::string File_Handler::next_token(){
+  // error messages only: whatever is there up to the next separator
+  std::string token = "";
+  for(const char* c = file_pos; c != file_stop && token.size() < 20; c++){
+    if(*c == ',' || *c == '}' || *c == ']' || isspace(*c))
+      break;
+    token += *c;
+  }
+  
+  return token;
+}
+
+
+
 //------------------------------------------------------------------------------
 bool File_Handler::valid_char(char c){
-  if(isalnum(c) || c == '"' || c == ':' || c == ',' || c == '.' || c == '{' || c == '}' || c == '[' || c == ']' || c == '-')
-    return true;
-    
-  return false;
+  return Structural_Index::is_token_char(c);   // same table as the pre-scan
 }
 
 
@@ -386,7 +839,12 @@ void File_Handler::check_char(char c){
   char next = next_char();
   if(next != c){
     std::stringstream message;
-    message << "Invalid file format! Expected '" << c << "' but found '" << next << "' in line " << line << ".";
+    message << "Invalid file format! Expected '" << c << "' but found ";
+    if(next == '\0')
+      message << "end of file";
+    else
+      message << "'" << next << "'";
+    message << " in line " << current_line() << ".";
     throw std::runtime_error(message.str());
   }
 }
@@ -395,30 +853,28 @@ void File_Handler::check_char(char c){
 
 //------------------------------------------------------------------------------
 void File_Handler::check_string(const std::string& string){
+  // record previous state, only needed for the error message
+  const char* tmp_pos = file_pos;
+  
+  if(match_string(string))
+    return;
+  
+  file_pos = tmp_pos;
   std::string next = next_string();
-  if(next != string){
-    std::stringstream message;
-    message << "Invalid file format! Expected '" << string << "' but found '" << next << "' in line " << line << ".";
-    throw std::runtime_error(message.str());
-  }
+  std::stringstream message;
+  message << "Invalid file format! Expected '" << string << "' but found '" << next << "' in line " << current_line() << ".";
+  throw std::runtime_error(message.str());
 }
 
 
 
 //------------------------------------------------------------------------------
 bool File_Handler::optional_check_char(char c){
-  // record previous state
-  std::size_t tmp_pos = file_pos;
-  std::size_t tmp_line = line;
+  if(peek_char() != c)
+    return false;
   
-  // check
-  if(next_char() == c)
-    return true;
-    
-  // revert
-  file_pos = tmp_pos;
-  line = tmp_line;
-  return false;
+  file_pos++;
+  return true;
 }
 
 
@@ -426,16 +882,14 @@ bool File_Handler::optional_check_char(char c){
 //------------------------------------------------------------------------------
 bool File_Handler::optional_check_string(const std::string& string){
   // record previous state
-  std::size_t tmp_pos = file_pos;
-  std::size_t tmp_line = line;
+  const char* tmp_pos = file_pos;
   
   // check
-  if(next_string() == string)
+  if(match_string(string))
     return true;
   
   // revert
   file_pos = tmp_pos;
-  line = tmp_line;
   return false;
 }
 
@@ -443,8 +897,5 @@ bool File_Handler::optional_check_string(const std::string& string){
 
 //------------------------------------------------------------------------------
 bool File_Handler::file_end(){
-  if(file_pos >= file_content.size())
-    return true;
-    
-  return false;
+  return file_pos >= file_stop;
 }
\ No newline at end of file
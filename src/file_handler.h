@@ -27,45 +27,92 @@ SOFTWARE.
 #pragma once
 
 #include <string>
-#include <string>
-#include <fstream>
 #include <memory>
+#include <span>
+#include <vector>
 
-#include "scene.h"
+#include "scene_target.h"
+#include "object_stream.h"
+#include "mapped_file.h"
+#include "binary_scene.h"
+#include "structural_index.h"
+#include "thread_pool.h"
 
 
 
-class File_Handler{
+class File_Handler : public Object_Stream{
 public:
-  void process(const std::string& file_name, std::shared_ptr<Scene> scene);
+  void set_threads(uint thread_count);   // for large object arrays, the pool is kept for every file after
+  bool process(const std::string& file_name, std::shared_ptr<Scene_Target> scene);   // text or binary, false on error
+  bool stream(const std::string& file_name, std::shared_ptr<Scene_Target> scene);   // settings only, objects follow through 'load_until()'
+  void convert(const std::string& file_name, const std::string& binary_file_name);
+  void benchmark(const std::string& file_name);   // parser throughput for every instruction set
+  void load_until(uint tick, Scene_Target& target);
+  bool done();
+  uint get_next_tick();
   
 private:
-  std::string file_content;
-  std::size_t file_pos;
+  std::unique_ptr< Mapped_File > file;
+  std::string file_name;
+  const char* file_start;
+  const char* file_pos;   // into the mapped file, only ever moves forward (except for look ahead)
+  const char* file_stop;
+  const char* line_pos;   // 'line' is counted up to here
   std::size_t line;
-  std::shared_ptr<Scene> scene;
+  Structural_Index index;   // token starts of one chunk, scanned ahead of 'file_pos'
+  const char* index_begin;
+  const char* index_end;
+  std::size_t index_cursor;   // next position in 'index' to look at
+  static constexpr std::size_t index_chunk_size = 64 * 1024;   // stays in cache
+  std::shared_ptr<Scene_Target> scene;
+  
+  // parallel parsing
+  std::shared_ptr< Thread_Pool > threads;   // null -> single threaded
+  static constexpr std::size_t min_chunk_size = 1024 * 1024;   // bytes of object array per task, below that splitting costs more than it saves
+  
+  // streaming
+  bool binary = false;
+  binary_scene_info binary_info;
+  uint64_t next_record = 0;
+  bool first_object = true;
+  bool stream_done = true;
+  object_description pending;   // read, not handed out yet
   
-  void load_file_content(const std::string& file_name);
+  bool load_file_content();
+  bool open_file();
+  void stream_next_object();
   void parse_file();
     void parse_scene();
       void parse_scene_name();
       void parse_background();
       void parse_time();
+      void parse_broadphase();
       void parse_object_array();
-        void parse_object();
+        bool parse_object_array_parallel();
+          const char* find_object_boundary(const char* from);
+          void init_chunk_parser(File_Handler& parent, const char* begin, const char* end);
+          void parse_object_chunk(bool last, std::vector< object_description >& objects);
+        void begin_object_array();
+        bool next_object(object_description& obj);
+          object_description parse_object();
           phy_obj_type parse_object_type();
           glm::vec2 parse_object_position();
           float parse_object_rotation();
           float parse_object_size();
           glm::vec3 parse_object_colour();
           uint parse_object_time();
-    std::vector<float> parse_float_array();
+    std::size_t parse_float_array(std::span< float > values);
   char next_char();
-    bool valid_char(char c);
-  char next_num();
+  char peek_char();
+    void skip_invalid_chars();
+      void scan_chunk(const char* begin);
+      bool valid_char(char c);
+  std::size_t current_line();
   std::string next_string();
+  bool match_string(const std::string& string);
   float next_float();
   uint next_uint();
+  std::string next_token();
   void check_char(char c);
   void check_string(const std::string& string);
   bool optional_check_char(char c);
@@ -0,0 +1,117 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "islands.h"
+
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <math.h>
+
+
+
+void Islands::update(Body_Store& bodies, Contact_Buffer& contacts, std::span< const body_pair > resting_pairs, float step_time){
+  std::size_t n = bodies.size();
+  
+  // every body on its own
+  parent.resize(n);
+  std::iota(parent.begin(), parent.end(), 0);
+  
+  // join whatever touches
+  for(auto &c : contacts)
+    unite(c.body_0, c.body_1);
+  for(auto &p : resting_pairs)
+    unite(p.i, p.j);
+  
+  update_rest_time(bodies, step_time);
+  
+  // an island rests as long as its most restless body
+  island_rest_time.assign(n, std::numeric_limits<float>::max());
+  for(std::size_t i = 0; i < n; i++){
+    float& rest_time = island_rest_time[ find(i) ];
+    rest_time = std::min(rest_time, bodies.rest_time[i]);
+  }
+  
+  awake_count = 0;
+  for(std::size_t i = 0; i < n; i++){
+    if(island_rest_time[ find(i) ] >= time_to_sleep)
+      bodies.sleep(i);
+    else{
+      bodies.wake(i);
+      awake_count++;
+    }
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Islands::get_awake_count(){  return awake_count;  }
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////////////
+
+void Islands::update_rest_time(Body_Store& bodies, float step_time){
+  for(std::size_t i = 0; i < bodies.size(); i++){
+    if( ! bodies.is_awake(i))
+      continue;   // keeps its rest time until woken
+    
+    bool slow =
+      glm::length(bodies.velocity[i]) < sleep_velocity &&
+      fabs(bodies.angular_velocity[i]) < sleep_spin;
+    bodies.rest_time[i] = slow ? bodies.rest_time[i] + step_time : 0.0f;
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Islands::find(std::size_t i){
+  // path halving
+  while(parent[i] != i){
+    parent[i] = parent[ parent[i] ];
+    i = parent[i];
+  }
+  
+  return i;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Islands::unite(std::size_t i, std::size_t j){
+  i = find(i);
+  j = find(j);
+  
+  // smaller index as root -> same islands no matter the order of joins
+  if(i < j)
+    parent[j] = i;
+  else
+    parent[i] = j;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <span>
+
+#include "body_store.h"
+#include "contact.h"
+#include "broadphase.h"
+
+
+
+// groups of touching bodies (union-find), a group falls asleep & wakes up as a whole
+class Islands{
+public:
+  void update(
+    Body_Store& bodies,
+    Contact_Buffer& contacts,   // this tick
+    std::span< const body_pair > resting_pairs,   // both asleep, narrowphase was skipped
+    float step_time
+  );
+  std::size_t get_awake_count();
+  
+private:
+  float sleep_velocity = 1.0f;   // units per second
+  float sleep_spin = 5.0f;   // degrees per second
+  float time_to_sleep = 0.5f;   // seconds below both thresholds
+  std::vector< std::size_t > parent;
+  std::vector< float > island_rest_time;   // shortest rest time within each island, by root
+  std::size_t awake_count = 0;
+  
+  void update_rest_time(Body_Store& bodies, float step_time);
+  std::size_t find(std::size_t i);
+  void unite(std::size_t i, std::size_t j);
+};
\ No newline at end of file
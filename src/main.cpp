@@ -25,16 +25,69 @@ SOFTWARE.
 */
 
 #include <iostream>
+#include <string>
+#include <exception>
+#include <stdexcept>
+#include <limits>
 #include "../simple_arg_parser/simple_arg_parser.h"
 #include "app.h"
 
 
 
+uint to_uint(const std::string& option, const std::string& value){
+	try{
+		std::size_t end;
+		unsigned long ret = std::stoul(value, &end);
+		if(end == value.size() && value[0] != '-' && ret <= std::numeric_limits< uint >::max())
+			return ret;
+	}
+	catch(std::exception& e){}
+	
+	throw std::runtime_error("Incorrect CLI argument: Invalid value '" + value + "' for option '--" + option + "' (0 to " + std::to_string(std::numeric_limits< uint >::max()) + ").");
+}
+
+
+
+//------------------------------------------------------------------------------
+float to_float(const std::string& option, const std::string& value){
+	try{
+		std::size_t end;
+		float ret = std::stof(value, &end);
+		if(end == value.size())
+			return ret;
+	}
+	catch(std::exception& e){}
+	
+	throw std::runtime_error("Incorrect CLI argument: Invalid value '" + value + "' for option '--" + option + "'.");
+}
+
+
+
+//------------------------------------------------------------------------------
 int main(int argc, char* argv[]){
 	
 	// parse CLI options
 	SArgParser parser;
 	SArgParser::opt_id help = parser.define_option('h', "help", true);
+	SArgParser::opt_id headless = parser.define_option('H', "headless", true);
+	SArgParser::opt_id threads = parser.define_option('t', "threads", false);
+	SArgParser::opt_id tick_rate = parser.define_option('r', "tick-rate", false);
+	SArgParser::opt_id frame_rate = parser.define_option('f', "frame-rate", false);
+	SArgParser::opt_id speed = parser.define_option('s', "speed", false);
+	SArgParser::opt_id batch = parser.define_option('b', "batch", true);
+	SArgParser::opt_id jobs = parser.define_option('j', "jobs", false);
+	SArgParser::opt_id contacts = parser.define_option('c', "contacts", true);
+	SArgParser::opt_id iterations = parser.define_option('i', "iterations", false);
+	SArgParser::opt_id convert = parser.define_option('C', "convert", true);
+	SArgParser::opt_id stream = parser.define_option('S', "stream", true);
+	SArgParser::opt_id parser_benchmark = parser.define_option('P', "parser-benchmark", true);
+	SArgParser::opt_id cache = parser.define_option('k', "cache", false);
+	SArgParser::opt_id checkpoint = parser.define_option('p', "checkpoint", false);
+	SArgParser::opt_id resume = parser.define_option('R', "resume", true);
+	SArgParser::opt_id record = parser.define_option('o', "record", false);
+	SArgParser::opt_id quantise = parser.define_option('q', "quantise", false);
+	SArgParser::opt_id trajectory = parser.define_option('T', "trajectory", false);
+	SArgParser::opt_id self_test = parser.define_option('x', "self-test", true);
 	
 	try{  parser.parse(argc, argv);  }
 	catch(std::exception& e){
@@ -49,7 +102,40 @@ int main(int argc, char* argv[]){
 		
 	else{
 		// run program
-		try{  app.run(parser.program_args());  }
+		try{
+			app.set_headless( parser.found_option(headless) );
+			if(parser.found_option(threads))
+				app.set_threads( to_uint("threads", parser.option_arg(threads)) );
+			if(parser.found_option(tick_rate))
+				app.set_tick_rate( to_uint("tick-rate", parser.option_arg(tick_rate)) );
+			if(parser.found_option(frame_rate))
+				app.set_frame_rate( to_uint("frame-rate", parser.option_arg(frame_rate)) );
+			if(parser.found_option(speed))
+				app.set_speed( to_float("speed", parser.option_arg(speed)) );
+			app.set_unthrottled( parser.found_option(batch) );
+			app.set_show_contacts( parser.found_option(contacts) );
+			app.set_convert( parser.found_option(convert) );
+			app.set_streaming( parser.found_option(stream) );
+			app.set_parser_benchmark( parser.found_option(parser_benchmark) );
+			if(parser.found_option(cache))
+				app.set_cache_directory( parser.option_arg(cache) );
+			if(parser.found_option(checkpoint))
+				app.set_checkpoint_interval( to_uint("checkpoint", parser.option_arg(checkpoint)) );
+			app.set_resume( parser.found_option(resume) );
+			if(parser.found_option(record))
+				app.set_recording( to_uint("record", parser.option_arg(record)) );
+			if(parser.found_option(quantise))
+				app.set_quantisation( to_float("quantise", parser.option_arg(quantise)) );
+			if(parser.found_option(trajectory))
+				app.set_trajectory_tick( to_uint("trajectory", parser.option_arg(trajectory)) );
+			app.set_self_test( parser.found_option(self_test) );
+			if(parser.found_option(iterations))
+				app.set_solver_iterations( to_uint("iterations", parser.option_arg(iterations)) );
+			if(parser.found_option(jobs))
+				app.set_jobs( to_uint("jobs", parser.option_arg(jobs)) );
+			
+			app.run(parser.program_args());
+		}
 		catch(std::exception& e){
 			std::cerr << "Error: " << e.what() << "\n";
 		}
@@ -0,0 +1,98 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "mapped_file.h"
+
+#include <exception>
+#include <stdexcept>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+
+Mapped_File::Mapped_File(const std::string& file_name){
+  file_descriptor = open(file_name.c_str(), O_RDONLY);
+  if(file_descriptor < 0)
+    throw std::runtime_error("Unable to open file '" + file_name + "'!");
+  
+  struct stat info;
+  if(fstat(file_descriptor, &info) < 0){
+    close(file_descriptor);
+    throw std::runtime_error("Unable to read size of file '" + file_name + "'!");
+  }
+  length = info.st_size;
+  
+  // nothing to map
+  if(length == 0)
+    return;
+  
+  data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+  if(data == MAP_FAILED){
+    close(file_descriptor);
+    throw std::runtime_error("Unable to map file '" + file_name + "'!");
+  }
+  
+  madvise(data, length, MADV_SEQUENTIAL);   // read once, front to back
+}
+
+
+
+//------------------------------------------------------------------------------
+Mapped_File::~Mapped_File(){
+  if(data != nullptr)
+    munmap(data, length);
+  
+  close(file_descriptor);
+}
+
+
+
+//------------------------------------------------------------------------------
+const char* Mapped_File::begin(){  return static_cast< const char* >(data);  }
+
+
+
+//------------------------------------------------------------------------------
+const char* Mapped_File::end(){  return begin() + length;  }
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Mapped_File::size(){  return length;  }
+
+
+
+//------------------------------------------------------------------------------
+void Mapped_File::release(const char* up_to){
+  // whole pages only
+  std::size_t page = sysconf(_SC_PAGESIZE);
+  std::size_t bytes = (up_to - begin()) / page * page;
+  if(bytes > 0)
+    madvise(data, bytes, MADV_DONTNEED);
+}
\ No newline at end of file
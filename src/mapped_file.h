@@ -0,0 +1,49 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <string>
+
+
+
+// read-only view of a whole file, mapped instead of copied
+class Mapped_File{
+public:
+  Mapped_File(const std::string& file_name);   // throws if the file can't be opened
+  ~Mapped_File();
+  Mapped_File(const Mapped_File&) = delete;
+  Mapped_File& operator=(const Mapped_File&) = delete;
+  const char* begin();
+  const char* end();
+  std::size_t size();
+  void release(const char* up_to);   // done reading everything before 'up_to', its pages may go
+  
+private:
+  int file_descriptor = -1;
+  void* data = nullptr;
+  std::size_t length = 0;
+};
\ No newline at end of file
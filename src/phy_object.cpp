@@ -28,6 +28,8 @@ SOFTWARE.
 
 #include <iostream>
 #include <math.h>
+#include <algorithm>
+#include <stdexcept>
 
 
 
@@ -35,21 +37,29 @@ SOFTWARE.
 // Object public
 ////////////////////////////////////////////////////////////////////////////////
 
-PhyObject::PhyObject(glm::vec2 position, float rotation, float size, glm::vec3 colour, uint time, id window_id){
+PhyObject::PhyObject(glm::vec2 position, float rotation, float size, glm::vec3 colour, uint time){
   this->position = position;
   this->rotation = fmod(rotation, 360.0f);
   this->size = size;
   this->colour = colour;
   this->time = time;
-  this->window_id = window_id;
 }
 
 
 
 //------------------------------------------------------------------------------
-PhyObject::~PhyObject(){
-  if( ! Window::got_closed(window_id))
-    Window::remove_gobject(window_id, gobj_id);
+PhyObject::~PhyObject(){}
+
+
+
+//------------------------------------------------------------------------------
+std::shared_ptr< PhyObject > PhyObject::create(phy_obj_type type, glm::vec2 pos, float rot, float size, glm::vec3 colour, uint time){
+  switch(type){
+    case triangle:  return std::make_shared<PhyTriangle>(pos, rot, size, colour, time);
+    case rectangle: return std::make_shared<PhyRect>(pos, rot, size, colour, time);
+    case circle:    return std::make_shared<PhyCircle>(pos, rot, size, colour, time);
+    default: throw std::runtime_error("Invalid Phy_Object type");
+  }
 }
 
 
@@ -60,46 +70,37 @@ uint PhyObject::get_time(){  return time;  }
 
 
 //------------------------------------------------------------------------------
-bool PhyObject::is_active(){  return activated;  }
+phy_obj_type PhyObject::get_type(){  return type;  }
 
 
 
 //------------------------------------------------------------------------------
-void PhyObject::update(){
-  update_rotation();
-  update_position();
-}
+glm::vec2 PhyObject::get_position(){  return position;  }
 
 
 
 //------------------------------------------------------------------------------
-void PhyObject::set_position(glm::vec2 pos){
-  position = pos;
-  Window::set_gobj_position(window_id, gobj_id, {pos.x, pos.y, 0.0f});
-}
+float PhyObject::get_rotation(){  return rotation;  }
 
 
 
 //------------------------------------------------------------------------------
-void PhyObject::set_rotation(float rot){
-  rotation = fmod(rot, 360.0f);
-  Window::set_gobj_rotation(window_id, gobj_id, rotation);
-}
+float PhyObject::get_size(){  return size;  }
 
 
 
 //------------------------------------------------------------------------------
-glm::vec2 PhyObject::get_position(){  return position;  }
+glm::vec3 PhyObject::get_colour(){  return colour;  }
 
 
 
 //------------------------------------------------------------------------------
-float PhyObject::get_rotation(){  return rotation;  }
+float PhyObject::get_bounding_radius(){  return bounding_radius;  }
 
 
 
 //------------------------------------------------------------------------------
-float PhyObject::get_size(){  return size;  }
+float PhyObject::get_radius(){  return radius;  }
 
 
 
@@ -109,12 +110,12 @@ std::vector< glm::vec2 > PhyObject::get_points(){  return points;  }
 
 
 //------------------------------------------------------------------------------
-glm::vec2 PhyObject::get_velocity(){  return velocity;  }
+std::vector< glm::vec2 > PhyObject::get_axes(){  return axes;  }
 
 
 
 //------------------------------------------------------------------------------
-float PhyObject::get_angular_velocity(){  return angular_velocity;  }
+glm::vec2 PhyObject::get_center_of_mass(){  return center_of_mass;  }
 
 
 
@@ -134,19 +135,24 @@ float PhyObject::get_inertia_tensor(){  return inertia_tensor;  }
 
 
 //------------------------------------------------------------------------------
-void PhyObject::apply_force(glm::vec2 force, glm::vec2 pos){
-  torque = cross_2d(force, pos);
+body_shape PhyObject::get_body_shape(){
+  body_shape shape = {type, size, points, axes, center_of_mass, bounding_radius, radius};
+  
+  // circles collide analytically, no outline needed
+  if(shape.radius > 0.0f){
+    shape.points.clear();
+    shape.axes.clear();
+    shape.bounding_radius = shape.radius;
+  }
+  
+  return shape;
 }
 
 
 
 //------------------------------------------------------------------------------
-void PhyObject::apply_impulse(float impulse, glm::vec2 rel_coll_point, glm::vec2 coll_normal){
-  // linear velocity
-  velocity += impulse * coll_normal * (1.0f / mass);
-  
-  // angular velocity
-  angular_velocity += cross_2d(rel_coll_point, impulse * coll_normal)  * (1.0f / inertia_tensor);
+prepared_object PhyObject::prepare(shape_id shape){
+  return {type, position, rotation, size, colour, time, mass, inertia_tensor, bounciness, shape};
 }
 
 
@@ -158,6 +164,8 @@ void PhyObject::apply_impulse(float impulse, glm::vec2 rel_coll_point, glm::vec2
 void PhyObject::init(){
   calc_inertia_tensor();
   calc_center_of_mass();
+  calc_bounding_radius();
+  calc_axes();
 }
 
 
@@ -189,26 +197,34 @@ void PhyObject::calc_center_of_mass(){
 
 
 //------------------------------------------------------------------------------
-void PhyObject::update_rotation(){
-  set_rotation(rotation + step_time * angular_velocity);   // update phy & graphics
+void PhyObject::calc_axes(){
+  axes.clear();
+  glm::vec2 prev_point = points.back();
   
-  float change = torque / inertia_tensor;
-  angular_velocity = angular_velocity + (step_time * change);
-  torque = 0.0f;
-}
-
-
-
-//------------------------------------------------------------------------------
-void PhyObject::update_position(){
-  set_position(position + step_time * velocity);   // update phy & graphics
+  for(auto &p : points){
+    glm::vec2 edge_vector = prev_point - p;
+    glm::vec2 axis = glm::normalize( glm::vec2( - edge_vector.y, edge_vector.x) );
+    prev_point = p;
+    
+    // opposite edges give the same separating axis
+    bool parallel = false;
+    for(auto &a : axes)
+      if( fabs(a.x * axis.y - a.y * axis.x) < 1e-6f )
+        parallel = true;
+    
+    if( ! parallel)
+      axes.push_back(axis);
+  }
 }
 
 
 
 //------------------------------------------------------------------------------
-float PhyObject::cross_2d(glm::vec2 v_0, glm::vec2 v_1){
-  return v_0.x * v_1.y - v_0.y - v_1.x;
+void PhyObject::calc_bounding_radius(){
+  bounding_radius = 0.0f;
+  
+  for(auto &p : points)
+    bounding_radius = std::max(bounding_radius, glm::length(p));
 }
 
 
@@ -217,9 +233,10 @@ float PhyObject::cross_2d(glm::vec2 v_0, glm::vec2 v_1){
 // Triangle public
 ////////////////////////////////////////////////////////////////////////////////
 
-PhyTriangle::PhyTriangle(glm::vec2 position, float rotation, float size, glm::vec3 colour, uint time, id window_id)
-  : PhyObject(position, rotation, size, colour, time, window_id){
+PhyTriangle::PhyTriangle(glm::vec2 position, float rotation, float size, glm::vec3 colour, uint time)
+  : PhyObject(position, rotation, size, colour, time){
 
+    type = triangle;
     calc_points();
     init();
 }
@@ -231,15 +248,6 @@ PhyTriangle::~PhyTriangle(){}
 
 
 
-//------------------------------------------------------------------------------
-void PhyTriangle::activate(){
-  glm::vec3 pos = {position.x, position.y, 0.0f};
-  gobj_id = Window::add_gobject(window_id, t_triangle, pos, rotation, size, colour);
-  activated = true;
-}
-
-
-
 ////////////////////////////////////////////////////////////////////////////////
 // Triangle private
 ////////////////////////////////////////////////////////////////////////////////
@@ -261,9 +269,10 @@ void PhyTriangle::calc_points(){
 // Rect public
 ////////////////////////////////////////////////////////////////////////////////
 
-PhyRect::PhyRect(glm::vec2 position, float rotation, float size, glm::vec3 colour, uint time, id window_id)
-  : PhyObject(position, rotation, size, colour, time, window_id){
+PhyRect::PhyRect(glm::vec2 position, float rotation, float size, glm::vec3 colour, uint time)
+  : PhyObject(position, rotation, size, colour, time){
 
+    type = rectangle;
     calc_points();
     init();
 }
@@ -275,15 +284,6 @@ PhyRect::~PhyRect(){}
 
 
 
-//------------------------------------------------------------------------------
-void PhyRect::activate(){
-  glm::vec3 pos = {position.x, position.y, 0.0f};
-  gobj_id = Window::add_gobject(window_id, t_rectangle, pos, rotation, size, colour);
-  activated = true;
-}
-
-
-
 ////////////////////////////////////////////////////////////////////////////////
 // Rect private
 ////////////////////////////////////////////////////////////////////////////////
@@ -305,9 +305,11 @@ void PhyRect::calc_points(){
 // Circle public
 ////////////////////////////////////////////////////////////////////////////////
 
-PhyCircle::PhyCircle(glm::vec2 position, float rotation, float size, glm::vec3 colour, uint time, id window_id)
-  : PhyObject(position, rotation, size, colour, time, window_id){
+PhyCircle::PhyCircle(glm::vec2 position, float rotation, float size, glm::vec3 colour, uint time)
+  : PhyObject(position, rotation, size, colour, time){
 
+    type = circle;
+    radius = size / 2;
     calc_points();
     init();
 }
@@ -319,15 +321,6 @@ PhyCircle::~PhyCircle(){}
 
 
 
-//------------------------------------------------------------------------------
-void PhyCircle::activate(){
-  glm::vec3 pos = {position.x, position.y, 0.0f};
-  gobj_id = Window::add_gobject(window_id, t_circle, pos, rotation, size, colour);
-  activated = true;
-}
-
-
-
 ////////////////////////////////////////////////////////////////////////////////
 // Cirlce private
 ////////////////////////////////////////////////////////////////////////////////
@@ -32,11 +32,12 @@ SOFTWARE.
 
 #include <glm/glm.hpp>
 
-#include "../simple_2d_graphics/src/window.h"
-#include "../simple_2d_graphics/src/graphics_object.h"
+#include "render_sink.h"
+#include "body_store.h"
 
 
 
+// object as loaded from a scene file, becomes a body in 'Body_Store' once activated
 class PhyObject{
 public:
   PhyObject(
@@ -44,56 +45,58 @@ public:
     float rotation,
     float size,
     glm::vec3 colour,
-    uint time,
-    id window_id
+    uint time
+  );
+  virtual ~PhyObject();
+  static std::shared_ptr< PhyObject > create(
+    phy_obj_type type,
+    glm::vec2 position,
+    float rotation,
+    float size,
+    glm::vec3 colour,
+    uint time
   );
-  ~PhyObject();
   uint get_time();
-  bool is_active();
-  virtual void activate() = 0;
-  void update();
-  void set_position(glm::vec2 pos);
-  void set_rotation(float rot);
+  phy_obj_type get_type();
   glm::vec2 get_position();
   float get_rotation();
   float get_size();
+  glm::vec3 get_colour();
+  float get_bounding_radius();
+  float get_radius();
   std::vector< glm::vec2 > get_points();   // compiler should optimise 'return by value' for std types
-  glm::vec2 get_velocity();
-  float get_angular_velocity();
+  std::vector< glm::vec2 > get_axes();
+  glm::vec2 get_center_of_mass();
   float get_bounciness();
   float get_mass();
   float get_inertia_tensor();
-  void apply_force(glm::vec2 force, glm::vec2 position);
-  void apply_impulse(float impulse, glm::vec2 rel_coll_point, glm::vec2 coll_normal);
+  body_shape get_body_shape();   // same for every object of this type & size
+  prepared_object prepare(shape_id shape);
   
 protected:
-  id window_id;
-  id gobj_id;
+  phy_obj_type type;
   uint time;
-  bool activated = false;
   
   glm::vec2 position;
   float rotation;
   float size;
   glm::vec3 colour;
   std::vector< glm::vec2 > points;   // order of ponits matter!
+  std::vector< glm::vec2 > axes;   // edge normals, parallel ones only once
+  float bounding_radius = 0.0f;
+  float radius = 0.0f;   // analytic circles only
   glm::vec2 center_of_mass = {0.0f, 0.0f};
   float inertia_tensor = 0.0f;
-  float angular_velocity = 0.0f;
-  float torque = 0.0f;
-  float step_time = 1.0f / 100.0f;   // duration of tick in seconds
   float mass = 0.1f;
   float adjustment_const = 100.0f;   // adjust this until simulation looks good
   float bounciness = 0.5f;   // keep between 0 and 1 !
-  glm::vec2 velocity = {0.0f, 0.0f};
   
   virtual void calc_points() = 0;
   void init();
   void calc_center_of_mass();
   void calc_inertia_tensor();
-  void update_rotation();
-  void update_position();
-  static float cross_2d(glm::vec2 v_0, glm::vec2 v_1);
+  void calc_bounding_radius();
+  void calc_axes();
 };
 
 
@@ -106,11 +109,9 @@ public:
     float rotation,
     float size,
     glm::vec3 colour,
-    uint time,
-    id window_id
+    uint time
   );
   ~PhyTriangle();
-  void activate();
   
 protected:
   void calc_points();
@@ -126,11 +127,9 @@ public:
     float rotation,
     float size,
     glm::vec3 colour,
-    uint time,
-    id window_id
+    uint time
   );
   ~PhyRect();
-  void activate();
   
 protected:
   void calc_points();
@@ -146,14 +145,12 @@ public:
     float rotation,
     float size,
     glm::vec3 colour,
-    uint time,
-    id window_id
+    uint time
   );
   ~PhyCircle();
-  void activate();
   
 protected:
-  uint point_count = 16;
+  uint point_count = 16;   // outline for mass distribution only, collisions use 'radius'
   
   void calc_points();
 };
\ No newline at end of file
@@ -0,0 +1,186 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "render_sink.h"
+
+#include <exception>
+#include <stdexcept>
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Window public
+////////////////////////////////////////////////////////////////////////////////
+
+Window_Sink::Window_Sink(){
+  window_id = Window::open("Uninitialised Name");
+}
+
+
+
+//------------------------------------------------------------------------------
+Window_Sink::~Window_Sink(){
+  for(auto &m : overlay_markers)
+    remove_gobject(m);
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Window_Sink::is_headless(){  return false;  }
+
+
+
+//------------------------------------------------------------------------------
+void Window_Sink::set_name(const std::string& name){
+  Window::set_window_name(window_id, name);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Window_Sink::set_background_colour(glm::vec3 colour){
+  Window::set_background_colour(window_id, colour);
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Window_Sink::got_closed(){
+  return Window::got_closed(window_id);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Window_Sink::add_gobjects(std::span< const gobj_description > gobjs, std::vector< id >& gobj_ids){
+  gobj_ids.clear();
+  
+  // no bulk registration in simple_2d_graphics either, one loop here instead of one call per body elsewhere
+  for(auto &g : gobjs){
+    gobject_type type;
+    switch(g.type){
+      case triangle:  type = t_triangle; break;
+      case rectangle: type = t_rectangle; break;
+      case circle:    type = t_circle; break;
+      default: throw std::runtime_error("Invalid Phy_Object type");
+    }
+    
+    gobj_ids.push_back( Window::add_gobject(window_id, type, {g.position, 0.0f}, g.rotation, g.size, g.colour) );
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Window_Sink::remove_gobject(id gobj_id){
+  if( ! Window::got_closed(window_id))
+    Window::remove_gobject(window_id, gobj_id);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Window_Sink::set_gobj_transforms(std::span< const gobj_transform > transforms){
+  // simple_2d_graphics has no bulk call (yet), so this is the only place looping over it
+  for(auto &t : transforms){
+    Window::set_gobj_position(window_id, t.gobj_id, {t.position.x, t.position.y, 0.0f});
+    Window::set_gobj_rotation(window_id, t.gobj_id, t.rotation);
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Window_Sink::set_overlay_points(std::span< const glm::vec2 > points){
+  // no point primitive in simple_2d_graphics, so markers are kept & moved around instead of re-created
+  while(overlay_markers.size() < points.size())
+    overlay_markers.push_back( Window::add_gobject(window_id, t_circle, {0.0f, 0.0f, 0.0f}, 3.0f, {1.0f, 1.0f, 1.0f}) );
+  
+  for(std::size_t i = 0; i < points.size(); i++)
+    Window::set_gobj_position(window_id, overlay_markers[i], {points[i].x, points[i].y, 0.0f});
+  
+  // park the ones not needed anymore
+  for(std::size_t i = points.size(); i < overlay_used; i++)
+    Window::set_gobj_position(window_id, overlay_markers[i], {-1.0e6f, -1.0e6f, 0.0f});
+  
+  overlay_used = points.size();
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Null public
+////////////////////////////////////////////////////////////////////////////////
+
+Null_Sink::Null_Sink(){}
+
+
+
+//------------------------------------------------------------------------------
+Null_Sink::~Null_Sink(){}
+
+
+
+//------------------------------------------------------------------------------
+bool Null_Sink::is_headless(){  return true;  }
+
+
+
+//------------------------------------------------------------------------------
+void Null_Sink::set_name(const std::string&){}
+
+
+
+//------------------------------------------------------------------------------
+void Null_Sink::set_background_colour(glm::vec3){}
+
+
+
+//------------------------------------------------------------------------------
+bool Null_Sink::got_closed(){  return false;  }
+
+
+
+//------------------------------------------------------------------------------
+void Null_Sink::add_gobjects(std::span< const gobj_description > gobjs, std::vector< id >& gobj_ids){
+  gobj_ids.assign(gobjs.size(), 0);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Null_Sink::remove_gobject(id){}
+
+
+
+//------------------------------------------------------------------------------
+void Null_Sink::set_gobj_transforms(std::span< const gobj_transform >){}
+
+
+
+//------------------------------------------------------------------------------
+void Null_Sink::set_overlay_points(std::span< const glm::vec2 >){}
\ No newline at end of file
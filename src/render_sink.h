@@ -0,0 +1,124 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <string>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../simple_2d_graphics/src/window.h"
+#include "../simple_2d_graphics/src/graphics_object.h"
+
+
+
+enum phy_obj_type{
+  triangle,
+  rectangle,
+  circle
+};
+
+
+
+// everything needed to register one body with the graphics side
+struct gobj_description{
+  phy_obj_type type;
+  glm::vec2 position;
+  float rotation;
+  float size;
+  glm::vec3 colour;
+};
+
+
+
+// one body's placement for the current frame
+struct gobj_transform{
+  id gobj_id;
+  glm::vec2 position;
+  float rotation;
+};
+
+
+
+// everything the simulation hands to the graphics side goes through here
+class Render_Sink{
+public:
+  virtual ~Render_Sink(){}
+  virtual bool is_headless() = 0;
+  virtual void set_name(const std::string& name) = 0;
+  virtual void set_background_colour(glm::vec3 colour) = 0;
+  virtual bool got_closed() = 0;
+  virtual void add_gobjects(   // a whole spawn wave at once
+    std::span< const gobj_description > gobjs,
+    std::vector< id >& gobj_ids   // same order as 'gobjs'
+  ) = 0;
+  virtual void set_overlay_points(std::span< const glm::vec2 > points) = 0;   // debug overlay, replaces the last set
+  virtual void remove_gobject(id gobj_id) = 0;
+  virtual void set_gobj_transforms(std::span< const gobj_transform > transforms) = 0;   // all at once, once per frame
+};
+
+
+
+//------------------------------------------------------------------------------
+// forwards to simple_2d_graphics
+class Window_Sink : public Render_Sink{
+public:
+  Window_Sink();
+  ~Window_Sink();
+  bool is_headless();
+  void set_name(const std::string& name);
+  void set_background_colour(glm::vec3 colour);
+  bool got_closed();
+  void add_gobjects(std::span< const gobj_description > gobjs, std::vector< id >& gobj_ids);
+  void remove_gobject(id gobj_id);
+  void set_gobj_transforms(std::span< const gobj_transform > transforms);
+  void set_overlay_points(std::span< const glm::vec2 > points);
+  
+private:
+  id window_id;
+  std::vector< id > overlay_markers;   // only ever grows, unused ones are parked out of sight
+  std::size_t overlay_used = 0;
+};
+
+
+
+//------------------------------------------------------------------------------
+// headless: never opens a window, every call is a no-op
+class Null_Sink : public Render_Sink{
+public:
+  Null_Sink();
+  ~Null_Sink();
+  bool is_headless();
+  void set_name(const std::string& name);
+  void set_background_colour(glm::vec3 colour);
+  bool got_closed();
+  void add_gobjects(std::span< const gobj_description > gobjs, std::vector< id >& gobj_ids);
+  void remove_gobject(id gobj_id);
+  void set_gobj_transforms(std::span< const gobj_transform > transforms);
+  void set_overlay_points(std::span< const glm::vec2 > points);
+};
\ No newline at end of file
@@ -0,0 +1,358 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "sat_kernel.h"
+
+#include <exception>
+#include <stdexcept>
+#include <random>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #define SAT_X86
+  #include <immintrin.h>
+#endif
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// public
+////////////////////////////////////////////////////////////////////////////////
+
+Sat_Kernel::Sat_Kernel()
+  : Sat_Kernel(detect_isa()){}
+
+
+
+//------------------------------------------------------------------------------
+Sat_Kernel::Sat_Kernel(sat_isa isa){
+  this->isa = isa;
+}
+
+
+
+//------------------------------------------------------------------------------
+sat_isa Sat_Kernel::get_isa(){  return isa;  }
+
+
+
+//------------------------------------------------------------------------------
+std::string Sat_Kernel::get_isa_name(sat_isa isa){
+  switch(isa){
+    case sat_scalar: return "scalar";
+    case sat_sse:    return "sse";
+    case sat_avx2:   return "avx2";
+    default: throw std::runtime_error("Invalid instruction set");
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+sat_isa Sat_Kernel::detect_isa(){
+  #ifdef SAT_X86
+    if( __builtin_cpu_supports("avx2") )
+      return sat_avx2;
+    if( __builtin_cpu_supports("sse2") )
+      return sat_sse;
+  #endif
+  
+  return sat_scalar;
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Sat_Kernel::overlap(const sat_shape& shape_0, const sat_shape& shape_1){
+  if(shape_0.points.empty() || shape_1.points.empty())
+    throw std::runtime_error("Collision detection: Cannot check polygon with zero points.");
+  
+  switch(isa){
+    case sat_avx2: return overlap_avx2(shape_0, shape_1);
+    case sat_sse:  return overlap_sse(shape_0, shape_1);
+    default:       return overlap_scalar(shape_0, shape_1);
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Sat_Kernel::overlap_batch(Body_Store& bodies, std::span< const body_pair > pairs, std::vector< uint8_t >& results){
+  results.resize( pairs.size() );
+  
+  for(std::size_t k = 0; k < pairs.size(); k++){
+    sat_shape shape_0 = {bodies.get_world_points(pairs[k].i), bodies.get_world_axes(pairs[k].i)};
+    sat_shape shape_1 = {bodies.get_world_points(pairs[k].j), bodies.get_world_axes(pairs[k].j)};
+    results[k] = overlap(shape_0, shape_1);
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Sat_Kernel::self_test(std::ostream& out, std::size_t pair_count){
+  // crowded random polygons of 3 to 16 corners -> every lane count & padding, about a third overlap
+  std::mt19937 random(1);
+  std::uniform_real_distribution< float > position(-3.0f, 3.0f);
+  std::uniform_real_distribution< float > radius(0.3f, 1.5f);
+  std::uniform_real_distribution< float > rotation(0.0f, 360.0f);
+  
+  Body_Store bodies;
+  std::size_t body_count = 1000;
+  for(std::size_t b = 0; b < body_count; b++){
+    shape_id shape = bodies.add_shape( regular_polygon(3 + b % 14, radius(random), b + 1.0f) );   // sizes differ -> shapes aren't merged
+    bodies.add({position(random), position(random)}, rotation(random), 1.0f, 1.0f, 0.0f, shape, {{1.0f, 1.0f, 1.0f}, 0, 0});
+  }
+  
+  std::vector< body_pair > pairs;
+  std::uniform_int_distribution< uint > body(0, body_count - 1);
+  while(pairs.size() < pair_count){
+    uint i = body(random);
+    uint j = body(random);
+    if(i != j)
+      pairs.push_back( {std::min(i, j), std::max(i, j)} );
+  }
+  
+  // scalar is the reference
+  std::vector< uint8_t > expected, results;
+  Sat_Kernel(sat_scalar).overlap_batch(bodies, pairs, expected);
+  std::size_t overlap_count = 0;
+  for(auto &e : expected)
+    overlap_count += e;
+  out << "Separating axis kernel self test: " << pairs.size() << " random polygon pairs, " << overlap_count << " overlapping.\n";
+  
+  bool ok = true;
+  for(sat_isa isa : {sat_sse, sat_avx2}){
+    if(isa > detect_isa()){
+      out << "  " << get_isa_name(isa) << ": not supported by this cpu, skipped.\n";
+      continue;
+    }
+    
+    Sat_Kernel(isa).overlap_batch(bodies, pairs, results);
+    std::size_t mismatch_count = 0;
+    for(std::size_t k = 0; k < pairs.size(); k++)
+      mismatch_count += results[k] != expected[k];
+    out << "  " << get_isa_name(isa) << ": " << mismatch_count << " pair(s) differ from scalar.\n";
+    ok = ok && mismatch_count == 0;
+  }
+  
+  return ok;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////////////
+
+bool Sat_Kernel::overlap_scalar(const sat_shape& shape_0, const sat_shape& shape_1){
+  // every edge normal of both polygons is a candidate for a separating line
+  for(auto axes : {shape_0.axes, shape_1.axes}){
+    for(auto &axis : axes){
+      bool overlap = check_proj_overlap(
+        project_polygon(axis, shape_0.points),
+        project_polygon(axis, shape_1.points)
+      );
+      
+      if( ! overlap)   // found separating line
+        return false;
+    }
+  }
+  
+  return true;   // no separating line found
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Sat_Kernel::overlap_sse(const sat_shape& shape_0, const sat_shape& shape_1){
+  #ifdef SAT_X86
+    std::size_t axis_count = gather_axes(shape_0, shape_1, 4);
+    
+    for(std::size_t a = 0; a < axis_count; a += 4){
+      __m128 ax = _mm_loadu_ps(axis_x.data() + a);
+      __m128 ay = _mm_loadu_ps(axis_y.data() + a);
+      __m128 min[2], max[2];
+      
+      // project every point onto 4 axes at once
+      for(int s = 0; s < 2; s++){
+        auto points = s == 0 ? shape_0.points : shape_1.points;
+        min[s] = max[s] = _mm_add_ps(
+          _mm_mul_ps(ax, _mm_set1_ps(points[0].x)),
+          _mm_mul_ps(ay, _mm_set1_ps(points[0].y))
+        );
+        
+        for(std::size_t p = 1; p < points.size(); p++){
+          __m128 proj = _mm_add_ps(
+            _mm_mul_ps(ax, _mm_set1_ps(points[p].x)),
+            _mm_mul_ps(ay, _mm_set1_ps(points[p].y))
+          );
+          min[s] = _mm_min_ps(proj, min[s]);
+          max[s] = _mm_max_ps(proj, max[s]);
+        }
+      }
+      
+      // same rule as 'check_proj_overlap()', per lane
+      __m128 first = _mm_cmplt_ps(min[0], min[1]);
+      __m128 overlap = _mm_or_ps(
+        _mm_and_ps(first, _mm_cmplt_ps(min[1], max[0])),
+        _mm_andnot_ps(first, _mm_cmplt_ps(min[0], max[1]))
+      );
+      
+      if(_mm_movemask_ps(overlap) != 0xF)   // found separating line
+        return false;
+    }
+    
+    return true;
+  #else
+    return overlap_scalar(shape_0, shape_1);
+  #endif
+}
+
+
+
+//------------------------------------------------------------------------------
+#ifdef SAT_X86
+__attribute__((target("avx2")))
+#endif
+bool Sat_Kernel::overlap_avx2(const sat_shape& shape_0, const sat_shape& shape_1){
+  #ifdef SAT_X86
+    std::size_t axis_count = gather_axes(shape_0, shape_1, 8);
+    
+    for(std::size_t a = 0; a < axis_count; a += 8){
+      __m256 ax = _mm256_loadu_ps(axis_x.data() + a);
+      __m256 ay = _mm256_loadu_ps(axis_y.data() + a);
+      __m256 min[2], max[2];
+      
+      // project every point onto 8 axes at once
+      for(int s = 0; s < 2; s++){
+        auto points = s == 0 ? shape_0.points : shape_1.points;
+        min[s] = max[s] = _mm256_add_ps(
+          _mm256_mul_ps(ax, _mm256_set1_ps(points[0].x)),
+          _mm256_mul_ps(ay, _mm256_set1_ps(points[0].y))
+        );
+        
+        for(std::size_t p = 1; p < points.size(); p++){
+          __m256 proj = _mm256_add_ps(
+            _mm256_mul_ps(ax, _mm256_set1_ps(points[p].x)),
+            _mm256_mul_ps(ay, _mm256_set1_ps(points[p].y))
+          );
+          min[s] = _mm256_min_ps(proj, min[s]);
+          max[s] = _mm256_max_ps(proj, max[s]);
+        }
+      }
+      
+      // same rule as 'check_proj_overlap()', per lane
+      __m256 first = _mm256_cmp_ps(min[0], min[1], _CMP_LT_OQ);
+      __m256 overlap = _mm256_or_ps(
+        _mm256_and_ps(first, _mm256_cmp_ps(min[1], max[0], _CMP_LT_OQ)),
+        _mm256_andnot_ps(first, _mm256_cmp_ps(min[0], max[1], _CMP_LT_OQ))
+      );
+      
+      if(_mm256_movemask_ps(overlap) != 0xFF)   // found separating line
+        return false;
+    }
+    
+    return true;
+  #else
+    return overlap_scalar(shape_0, shape_1);
+  #endif
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Sat_Kernel::gather_axes(const sat_shape& shape_0, const sat_shape& shape_1, std::size_t lanes){
+  axis_x.clear();
+  axis_y.clear();
+  
+  for(auto axes : {shape_0.axes, shape_1.axes}){
+    for(auto &a : axes){
+      axis_x.push_back(a.x);
+      axis_y.push_back(a.y);
+    }
+  }
+  
+  // pad by repeating the last axis, testing it twice changes nothing
+  while( ! axis_x.empty() && axis_x.size() % lanes != 0){
+    axis_x.push_back( axis_x.back() );
+    axis_y.push_back( axis_y.back() );
+  }
+  
+  return axis_x.size();
+}
+
+
+
+//------------------------------------------------------------------------------
+Sat_Kernel::projection Sat_Kernel::project_polygon(glm::vec2 axis, std::span< const glm::vec2 > polygon){
+  float min, max;
+  min = max = glm::dot(axis, polygon[0]);
+  
+  // project point onto axis and compare to prev min/max
+  for(std::size_t i = 1; i < polygon.size(); i++){
+    float proj = glm::dot(axis, polygon[i]);
+    
+    if(proj < min)
+      min = proj;
+      
+    if(proj > max)
+      max = proj;
+  }
+  
+  return {min, max};
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Sat_Kernel::check_proj_overlap(projection proj_0, projection proj_1){
+  if(proj_0.min < proj_1.min)
+    return proj_1.min < proj_0.max;   // min0 ----- min1 -- max0 ----- max1
+    
+  return proj_0.min < proj_1.max;   // min1 ----- min0 -- max1 ----- max0
+}
+
+
+
+//------------------------------------------------------------------------------
+body_shape Sat_Kernel::regular_polygon(std::size_t corners, float radius, float size){
+  body_shape shape = {};
+  shape.type = triangle;   // any polygon type, the kernel only sees points & axes
+  shape.size = size;
+  shape.bounding_radius = radius;
+  
+  for(std::size_t i = 0; i < corners; i++){
+    float angle = 2.0f * M_PI * i / corners;
+    shape.points.push_back( {radius * std::cos(angle), radius * std::sin(angle)} );
+  }
+  for(std::size_t i = 0; i < corners; i++){
+    glm::vec2 edge = shape.points[(i + 1) % corners] - shape.points[i];
+    shape.axes.push_back( glm::normalize( glm::vec2(-edge.y, edge.x) ) );
+  }
+  
+  return shape;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <span>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "body_store.h"
+#include "broadphase.h"
+
+
+
+struct sat_shape{   // world space data of one body, see 'Body_Store::get_world_points()'
+  std::span< const glm::vec2 > points;
+  std::span< const glm::vec2 > axes;
+};
+
+enum sat_isa{
+  sat_scalar,
+  sat_sse,
+  sat_avx2
+};
+
+
+
+// separating axis test, vector versions project both polygons onto 4 / 8 axes at once
+class Sat_Kernel{
+public:
+  Sat_Kernel();   // fastest instruction set supported by this cpu
+  Sat_Kernel(sat_isa isa);
+  sat_isa get_isa();
+  static std::string get_isa_name(sat_isa isa);
+  static sat_isa detect_isa();
+  bool overlap(const sat_shape& shape_0, const sat_shape& shape_1);
+  void overlap_batch(
+    Body_Store& bodies,
+    std::span< const body_pair > pairs,   // dense indices into 'bodies'
+    std::vector< uint8_t >& results   // 1 for every overlapping pair, same order as 'pairs'
+  );
+  static bool self_test(std::ostream& out, std::size_t pair_count = 200000);   // every supported vector version against the scalar one
+  
+private:
+  struct projection{
+    float min;
+    float max;
+  };
+  
+  sat_isa isa;
+  std::vector< float > axis_x;   // axes of both shapes split into x & y, padded to full lanes
+  std::vector< float > axis_y;
+  
+  bool overlap_scalar(const sat_shape& shape_0, const sat_shape& shape_1);
+  bool overlap_sse(const sat_shape& shape_0, const sat_shape& shape_1);
+  bool overlap_avx2(const sat_shape& shape_0, const sat_shape& shape_1);
+  std::size_t gather_axes(const sat_shape& shape_0, const sat_shape& shape_1, std::size_t lanes);
+  static projection project_polygon(glm::vec2 axis, std::span< const glm::vec2 > polygon);
+  static bool check_proj_overlap(projection proj_0, projection proj_1);
+  static body_shape regular_polygon(std::size_t corners, float radius, float size);
+};
\ No newline at end of file
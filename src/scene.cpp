@@ -25,35 +25,51 @@ SOFTWARE.
 */
 
 #include "scene.h"
+#include "mapped_file.h"
 
 #include <iostream>
 #include <exception>
 #include <chrono>
+#include <thread>
+#include <algorithm>
 using namespace std::chrono;
 
 
 
-Scene::Scene(){
-  window_id = Window::open("Uninitialised Name");
+Scene::Scene(bool headless){
+  if(headless)
+    render = std::make_shared<Null_Sink>();
+  else
+    render = std::make_shared<Window_Sink>();
+  
+  out = &std::cout;
+  set_threads(1);
 }
 
 
 
 //------------------------------------------------------------------------------
-Scene::~Scene(){}
+Scene::~Scene(){
+  stop_render_thread();
+  
+  for(auto &c : bodies.cold)
+    render->remove_gobject(c.gobj_id);
+}
 
 
 
 //------------------------------------------------------------------------------
 void Scene::set_name(const std::string& name){
-  Window::set_window_name(window_id, name);
+  this->name = name;
+  render->set_name(name);
 }
 
 
 
 //------------------------------------------------------------------------------
 void Scene::set_background_colour(glm::vec3 colour){
-  Window::set_background_colour(window_id, colour);
+  background_colour = colour;
+  render->set_background_colour(colour);
 }
 
 
@@ -65,42 +81,266 @@ void Scene::set_time(uint time){
 
 
 
+//------------------------------------------------------------------------------
+void Scene::set_broadphase(broadphase_type type){
+  broadphase_kind = type;
+  broadphase = Broadphase::create(type);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_threads(uint thread_count){
+  if(thread_count < 1)
+    throw std::runtime_error("Scene needs at least one thread.");
+  
+  threads = std::make_shared<Thread_Pool>(thread_count);
+  
+  narrowphases.clear();
+  for(uint i = 0; i < thread_count; i++)
+    narrowphases.push_back( std::make_unique<Collision>(bodies) );
+    
+  chunk_contacts.resize(thread_count);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_tick_rate(uint tick_rate){
+  if(tick_rate < 1)
+    throw std::runtime_error("Tick rate has to be at least 1 per second.");
+  
+  this->tick_rate = tick_rate;
+  step_time = 1.0f / tick_rate;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_frame_rate(uint frame_rate){
+  if(frame_rate < 1)
+    throw std::runtime_error("Frame rate has to be at least 1 per second.");
+  
+  this->frame_rate = frame_rate;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_speed(float speed){
+  if( !(speed > 0.0f) )
+    throw std::runtime_error("Speed has to be greater than 0.");
+  
+  this->speed = speed;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_unthrottled(bool unthrottled){
+  this->unthrottled = unthrottled;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_output(std::ostream& out){
+  this->out = &out;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_show_contacts(bool show_contacts){
+  this->show_contacts = show_contacts;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_solver_iterations(uint iterations){
+  solver.set_iterations(iterations);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_object_stream(std::shared_ptr< Object_Stream > stream){
+  this->stream = stream;
+}
+
+
+
 //------------------------------------------------------------------------------
 void Scene::add_object(glm::vec2 pos, float rot, float size, glm::vec3 colour, uint time, phy_obj_type type){
-  // add objects
-  std::shared_ptr<PhyObject> obj;
-  switch(type){
-    case triangle:  obj = std::make_shared<PhyTriangle>(pos, rot, size, colour, time, window_id); break;
-    case rectangle: obj = std::make_shared<PhyRect>(pos, rot, size, colour, time, window_id); break;
-    case circle:    obj = std::make_shared<PhyCircle>(pos, rot, size, colour, time, window_id); break;
-    default: throw std::runtime_error("Invalid Phy_Object type");
-  }
+  // shape & mass now, the object itself isn't needed any more
+  std::shared_ptr<PhyObject> obj = PhyObject::create(type, pos, rot, size, colour, time);
+  add_prepared_object( obj->prepare( add_shape(obj->get_body_shape()) ) );
+}
+
+
+
+//------------------------------------------------------------------------------
+shape_id Scene::add_shape(const body_shape& shape){
+  return bodies.add_shape(shape);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::add_prepared_object(const prepared_object& obj){
+  spawns.add(obj);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_load_info(const std::string& info){
+  load_info = info;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_checkpoints(uint interval, const std::string& file_name){
+  checkpoint_interval = interval;
+  checkpoint_file_name = file_name;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::load_checkpoint(const std::string& file_name){
+  Mapped_File file(file_name);
+  Checkpoint_In in( {file.begin(), file.size()} );
+  
+  // settings
+  set_name( in.read_string() );
+  set_background_colour( in.read_value< glm::vec3 >() );
+  set_time( in.read_value< uint32_t >() );
+  uint32_t kind = in.read_value< uint32_t >();
+  if(kind > bp_aabb_tree)
+    throw std::runtime_error("Invalid checkpoint! Unknown broadphase.");
+  set_broadphase( (broadphase_type) kind );
+  set_tick_rate( in.read_value< uint32_t >() );
+  ticks_passed = in.read_value< uint32_t >();
+  force_applied = in.read_value< uint8_t >();
+  if(ticks_passed != in.get_tick())
+    throw std::runtime_error("Invalid checkpoint! Tick doesn't match its header.");
+  
+  // statistics, so they add up as if it never stopped
+  pair_count = in.read_value< uint64_t >();
+  brute_force_pair_count = in.read_value< uint64_t >();
+  contact_count = in.read_value< uint64_t >();
+  warm_started_count = in.read_value< uint64_t >();
+  asleep_body_ticks = in.read_value< uint64_t >();
+  skipped_ticks = in.read_value< uint64_t >();
+  spawned_count = in.read_value< uint64_t >();
+  spawn_time = in.read_value< double >();
+  max_spawn_time = in.read_value< double >();
+  
+  // state
+  bodies.load(in);
+  solver.load(in);
+  spawns.load(in, bodies.shapes);
+  if( ! in.done())
+    throw std::runtime_error("Invalid checkpoint! Data left after the end.");
+  
+  register_gobjects();
+  first_tick = ticks_passed;
+  set_load_info("resumed from checkpoint '" + file_name + "' at tick " + std::to_string(ticks_passed));
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::set_recording(uint interval, float step, const std::string& file_name){
+  if(step < 0.0f)
+    throw std::runtime_error("Trajectory quantisation step can't be negative.");
   
-  this->phy_objects_wait.push(obj);
+  record_interval = interval;
+  record_step = step;
+  record_file_name = file_name;
 }
 
 
 
 //------------------------------------------------------------------------------
 void Scene::start(){
+  spawns.build();
+  read_stream();
   run();  
 }
 
 
 
+//------------------------------------------------------------------------------
+uint Scene::get_ticks_passed(){  return ticks_passed;  }
+
+
+
+//------------------------------------------------------------------------------
+double Scene::get_wall_time(){  return wall_time;  }
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 // private
 ////////////////////////////////////////////////////////////////////////////////
 
+void Scene::register_gobjects(){
+  wave_gobjs.clear();
+  for(std::size_t i = 0; i < bodies.size(); i++){
+    const body_shape& shape = bodies.get_shape(i);
+    wave_gobjs.push_back( {shape.type, bodies.position[i], bodies.rotation[i], shape.size, bodies.cold[ bodies.ids[i] ].colour} );
+  }
+  render->add_gobjects(wave_gobjs, wave_gobj_ids);
+  
+  for(std::size_t i = 0; i < bodies.size(); i++)
+    bodies.cold[ bodies.ids[i] ].gobj_id = wave_gobj_ids[i];
+}
+
+
+
+//------------------------------------------------------------------------------
 void Scene::run(){
-  loop_timer();
+  if(checkpoint_interval > 0){
+    if(stream)
+      throw std::runtime_error("Checkpoints need the whole scene loaded up front, not streamed.");
+    checkpoint_writer = std::make_unique<Checkpoint_Writer>();
+    next_checkpoint = (ticks_passed / checkpoint_interval + 1) * checkpoint_interval;
+  }
+  if(record_interval > 0){
+    recorder = std::make_unique<Trajectory_Writer>(record_file_name, record_interval, record_step);
+    next_record = (ticks_passed / record_interval + 1) * record_interval;
+  }
+  
+  start_render_thread();
+  
+  auto time_start = steady_clock::now();
+  if(unthrottled)
+    loop_unthrottled();
+  else
+    loop_timer();
+  wall_time = duration< double >(steady_clock::now() - time_start).count();
+  
+  stop_render_thread();
+  if(checkpoint_writer)
+    checkpoint_writer->finish();   // waits for the last one
+  if(recorder)
+    recorder->finish();
   
   // finished
-  std::cout << "Done.\n";
+  *out << "Done.\n";
+  print_statistics();
+  
+  // nothing to look at
+  if( render->is_headless() )
+    return;
   
   // wait for window to close
   while(true){
-    if( Window::got_closed(window_id) )
+    if( render->got_closed() )
       break;
     
     std::this_thread::sleep_for(10ms);
@@ -109,38 +349,67 @@ void Scene::run(){
 
 
 
+//------------------------------------------------------------------------------
+void Scene::start_render_thread(){
+  if( render->is_headless() )
+    return;
+  
+  publish_snapshot();   // whatever is there before the first tick
+  rendering = true;
+  render_thread = std::thread(&Scene::loop_render, this);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::stop_render_thread(){
+  if( ! render_thread.joinable() )
+    return;
+  
+  rendering = false;
+  render_thread.join();
+}
+
+
+
 //------------------------------------------------------------------------------
 void Scene::loop_timer(){
   // init
-  uint time_prev = current_time();
-  uint time_diff = 0;
+  uint interval_us = std::max(1000000.0f / (tick_rate * speed), 1.0f);
+  tick_interval = interval_us / 1000000.0f;
+  auto interval = microseconds(interval_us);
+  std::size_t max_catch_up = std::max(max_catch_up_time / interval_us, 1u);   // ticks back to back, at most
+  auto next_tick = steady_clock::now();
   
-  // wait for tick
-  while(ticks_passed < time && ! Window::got_closed(window_id)){
-    // time since last check
-    time_diff += current_time() - time_prev;
-    
-    // tick
-    if(time_diff > 9900){
+  while(ticks_passed < time && ! render->got_closed()){
+    // every tick that is due, a slow one is caught up with
+    std::size_t due = 0;
+    while(steady_clock::now() >= next_tick && ticks_passed < time && due < max_catch_up){
       loop_tick();
-      time_diff = 0;
+      next_tick += interval;
+      due++;
     }
     
-    // next wait
-    time_prev = current_time();
-    std::this_thread::sleep_for(500us);
+    // too far behind, the rest is given up instead of racing for ever
+    auto now = steady_clock::now();
+    if(now >= next_tick){
+      late_ticks += (now - next_tick) / interval + 1;
+      next_tick = now + interval;
+    }
+    
+    // next deadline, but keep an eye on the window
+    std::this_thread::sleep_until( std::min(next_tick, now + 10ms) );
   }
 }
 
 
 
 //------------------------------------------------------------------------------
-uint Scene::current_time(){  
-  auto now = time_point_cast<microseconds>(steady_clock::now());
-  auto time = now.time_since_epoch();
-  auto time_ms = std::chrono::duration_cast<std::chrono::microseconds>(time);
+void Scene::loop_unthrottled(){
+  tick_interval = 0.0f;
   
-  return time_ms.count();
+  while(ticks_passed < time && ! render->got_closed())
+    loop_tick();
 }
 
 
@@ -151,31 +420,99 @@ void Scene::loop_tick(){
   update_objects();
   ticks_passed++;
   
+  // nobody moves, nothing to watch -> straight on to the next spawn
+  if(islands.get_awake_count() == 0 && (unthrottled || render->is_headless()))
+    skip_idle_ticks();
+  
+  if( ! render->is_headless() )
+    publish_snapshot();
+  
   // test
-  static bool force_applied = false;
-  if(phy_objects.size() > 1 && ! force_applied){
-    phy_objects[0]->apply_force({10000.0f, 0.0f}, {1.0f, 1.0f});
+  if(bodies.size() > 1 && ! force_applied){
+    bodies.apply_force(0, {10000.0f, 0.0f}, {1.0f, 1.0f});
     force_applied = true;
   }
+  
+  if(checkpoint_interval > 0 && ticks_passed >= next_checkpoint)
+    save_checkpoint();
+  if(recorder && ticks_passed >= next_record)
+    record_frame();
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::skip_idle_ticks(){
+  uint next_tick = time;
+  if( ! spawns.empty())
+    next_tick = std::min(spawns.get_next_tick(), time);
+  else if(stream && ! stream->done())
+    next_tick = std::min(stream->get_next_tick(), time);
+  
+  if(next_tick <= ticks_passed)
+    return;
+  
+  asleep_body_ticks += bodies.size() * (next_tick - ticks_passed);
+  skipped_ticks += next_tick - ticks_passed;
+  ticks_passed = next_tick;
 }
 
 
 
 //------------------------------------------------------------------------------
 void Scene::check_activate_objects(){
-  for( ; ! phy_objects_wait.empty(); phy_objects_wait.pop()){
-    auto obj = phy_objects_wait.top();
-    
-    // activate
-    if( obj->get_time() <= ticks_passed ){
-      obj->activate();
-      phy_objects.push_back(obj);
-    }
-    
-    // skip and wait
-    else
-      break;
+  read_stream();
+  
+  if(spawns.empty() || spawns.get_next_tick() > ticks_passed)
+    return;
+  
+  auto time_start = steady_clock::now();
+  activate_wave( spawns.take_due(ticks_passed) );
+  
+  // statistics
+  double seconds = duration< double >(steady_clock::now() - time_start).count();
+  spawn_time += seconds;
+  max_spawn_time = std::max(max_spawn_time, seconds);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::read_stream(){
+  if( ! stream)
+    return;
+  
+  stream->load_until(ticks_passed + stream_lookahead, *this);
+  if(stream->done())
+    stream.reset();   // closes the file
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::activate_wave(std::span< const prepared_object > wave){
+  // graphics: one registration for the whole wave
+  wave_gobjs.clear();
+  for(auto &obj : wave)
+    wave_gobjs.push_back( {obj.type, obj.position, obj.rotation, obj.size, obj.colour} );
+  render->add_gobjects(wave_gobjs, wave_gobj_ids);
+  
+  // physics, shapes were added while loading
+  bodies.reserve( wave.size() );
+  for(std::size_t k = 0; k < wave.size(); k++){
+    auto& obj = wave[k];
+    bodies.add(
+      obj.position,
+      obj.rotation,
+      obj.mass,
+      obj.inertia_tensor,
+      obj.bounciness,
+      obj.shape,
+      {obj.colour, obj.time, wave_gobj_ids[k]}
+    );
   }
+  
+  spawned_count += wave.size();
 }
 
 
@@ -184,23 +521,266 @@ void Scene::check_activate_objects(){
 void Scene::update_objects(){
   // collisions
   handle_collisions();
-  if(collisions.size() > 1000)
-    collisions.clear();
   
-  // update individual objects
-  for(auto &o : phy_objects)
-    o->update();
+  // update all bodies at once
+  bodies.integrate(step_time);
+  bodies.update_world_cache();
 }
 
 
 
 //------------------------------------------------------------------------------
 void Scene::handle_collisions(){
-  for(std::size_t i = 0; i < phy_objects.size(); i++){
-    for(std::size_t j = i + 1; j < phy_objects.size(); j++){
-      std::shared_ptr<Collision> col = std::make_shared<Collision>(phy_objects[i], phy_objects[j], window_id);
-      col->handle();
-      collisions.push_back(col);
-    }
+  find_candidate_pairs();
+  
+  // detect (positions only)
+  contacts.reset();
+  detect_contacts();
+  
+  // resolve (velocities), always in pair order -> same result for any thread count
+  solver.solve(contacts, step_time);
+  contact_count += contacts.size();
+  warm_started_count += solver.get_warm_started();
+  
+  // fall asleep / wake up
+  islands.update(bodies, contacts, resting_pairs, step_time);
+  asleep_body_ticks += bodies.size() - islands.get_awake_count();
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::find_candidate_pairs(){
+  bounds.clear();
+  
+  for(std::size_t i = 0; i < bodies.size(); i++){
+    float r = bodies.get_shape(i).bounding_radius;
+    glm::vec2 extent = {r, r};
+    bounds.push_back( {bodies.position[i] - extent, bodies.position[i] + extent} );
   }
+  
+  broadphase->find_pairs(bounds, candidate_pairs);
+  
+  // two sleeping bodies stay where they are, no need to look closer
+  resting_pairs.clear();
+  std::size_t kept = 0;
+  for(auto &p : candidate_pairs){
+    if(bodies.is_awake(p.i) || bodies.is_awake(p.j))
+      candidate_pairs[kept++] = p;
+    else
+      resting_pairs.push_back(p);
+  }
+  candidate_pairs.resize(kept);
+  
+  // statistics
+  std::size_t n = bodies.size();
+  pair_count += candidate_pairs.size();
+  brute_force_pair_count += n > 1 ? n * (n - 1) / 2 : 0;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::detect_contacts(){
+  if(narrowphases.size() == 1 || candidate_pairs.size() < min_parallel_pairs){
+    narrowphases[0]->detect(candidate_pairs, contacts);
+    return;
+  }
+  
+  threads->run(narrowphases.size(), [this](std::size_t chunk){  detect_chunk(chunk);  });
+  
+  // gather in chunk order = pair order
+  for(auto &c : chunk_contacts)
+    contacts.append(c);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::detect_chunk(std::size_t chunk){
+  std::size_t chunks = narrowphases.size();
+  std::size_t begin = candidate_pairs.size() * chunk / chunks;
+  std::size_t end = candidate_pairs.size() * (chunk + 1) / chunks;
+  
+  chunk_contacts[chunk].reset();
+  narrowphases[chunk]->detect(
+    std::span< const body_pair >(candidate_pairs).subspan(begin, end - begin),
+    chunk_contacts[chunk]
+  );
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::publish_snapshot(){
+  transform_snapshot& snapshot = snapshots.get_back();   // buffers are reused, no allocation once grown
+  
+  snapshot.gobj_ids.resize( bodies.size() );
+  for(std::size_t i = 0; i < bodies.size(); i++)
+    snapshot.gobj_ids[i] = bodies.cold[ bodies.ids[i] ].gobj_id;
+  snapshot.prev_position = bodies.prev_position;
+  snapshot.position = bodies.position;
+  snapshot.prev_rotation = bodies.prev_rotation;
+  snapshot.rotation = bodies.rotation;
+  snapshot.time = steady_clock::now();
+  snapshot.tick_interval = tick_interval;
+  
+  if(show_contacts){
+    snapshot.contact_points.clear();
+    for(auto &c : contacts)
+      snapshot.contact_points.push_back(c.coll_point);
+  }
+  
+  snapshots.publish();
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::save_checkpoint(){
+  auto time_start = steady_clock::now();
+  checkpoint_out.begin(ticks_passed);
+  
+  // settings
+  checkpoint_out.write_string(name);
+  checkpoint_out.write_value< glm::vec3 >(background_colour);
+  checkpoint_out.write_value< uint32_t >(time);
+  checkpoint_out.write_value< uint32_t >(broadphase_kind);
+  checkpoint_out.write_value< uint32_t >(tick_rate);
+  checkpoint_out.write_value< uint32_t >(ticks_passed);
+  checkpoint_out.write_value< uint8_t >(force_applied);
+  
+  // statistics
+  checkpoint_out.write_value< uint64_t >(pair_count);
+  checkpoint_out.write_value< uint64_t >(brute_force_pair_count);
+  checkpoint_out.write_value< uint64_t >(contact_count);
+  checkpoint_out.write_value< uint64_t >(warm_started_count);
+  checkpoint_out.write_value< uint64_t >(asleep_body_ticks);
+  checkpoint_out.write_value< uint64_t >(skipped_ticks);
+  checkpoint_out.write_value< uint64_t >(spawned_count);
+  checkpoint_out.write_value< double >(spawn_time);
+  checkpoint_out.write_value< double >(max_spawn_time);
+  
+  // state
+  bodies.save(checkpoint_out);
+  solver.save(checkpoint_out);
+  spawns.save(checkpoint_out);
+  checkpoint_out.finish();
+  
+  // the disk is the writer's business
+  checkpoint_writer->write(checkpoint_file_name, checkpoint_out.get_data());
+  next_checkpoint = (ticks_passed / checkpoint_interval + 1) * checkpoint_interval;
+  checkpoint_count++;
+  checkpoint_time += duration< double >(steady_clock::now() - time_start).count();
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::record_frame(){
+  // copy only, encoding & writing is the recorder's business
+  trajectory_frame& frame = recorder->get_frame();
+  frame.tick = ticks_passed;
+  frame.ids = bodies.ids;
+  frame.position = bodies.position;
+  frame.rotation = bodies.rotation;
+  frame.velocity = bodies.velocity;
+  frame.angular_velocity = bodies.angular_velocity;
+  recorder->push();
+  
+  // skipped idle ticks get no frames, nothing moved
+  next_record = (ticks_passed / record_interval + 1) * record_interval;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::loop_render(){
+  auto frame_interval = duration< double >(1.0 / frame_rate);
+  auto next_frame = steady_clock::now();
+  
+  while(rendering){
+    // latest complete tick, somewhere between it & the one before
+    const transform_snapshot& snapshot = snapshots.get_latest();
+    float alpha = 1.0f;
+    if(snapshot.tick_interval > 0.0f)
+      alpha = duration< float >(steady_clock::now() - snapshot.time).count() / snapshot.tick_interval;
+    update_render(snapshot, alpha);
+    if(show_contacts)
+      render->set_overlay_points(snapshot.contact_points);
+    
+    next_frame += duration_cast< steady_clock::duration >(frame_interval);
+    std::this_thread::sleep_until(next_frame);
+  }
+  
+  // show where things ended up
+  update_render(snapshots.get_latest(), 1.0f);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::update_render(const transform_snapshot& snapshot, float alpha){
+  alpha = std::max(0.0f, std::min(1.0f, alpha));
+  transforms.resize( snapshot.gobj_ids.size() );
+  
+  // blend previous & current tick
+  for(std::size_t i = 0; i < snapshot.gobj_ids.size(); i++){
+    glm::vec2 position = snapshot.prev_position[i] + (snapshot.position[i] - snapshot.prev_position[i]) * alpha;
+    
+    float turn = snapshot.rotation[i] - snapshot.prev_rotation[i];   // shortest way, rotation wraps at 360
+    if(turn > 180.0f)
+      turn -= 360.0f;
+    if(turn < -180.0f)
+      turn += 360.0f;
+    float rotation = snapshot.prev_rotation[i] + turn * alpha;
+    
+    transforms[i] = {snapshot.gobj_ids[i], position, rotation};
+  }
+  
+  render->set_gobj_transforms(transforms);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene::print_statistics(){
+  std::size_t ticks = std::max(ticks_passed, (uint) 1);
+  double seconds = std::max(wall_time, 1e-6);
+  
+  if( ! load_info.empty())
+    *out << "Loading: " << load_info << "\n";
+  uint ticks_run = ticks_passed - first_tick;   // this run only
+  *out
+    << "Ran " << ticks_run << " ticks in " << wall_time << " s wall time ("
+    << ticks_run / seconds << " ticks/s, "
+    << ticks_run * step_time / seconds << "x real time).\n"
+    << "Broadphase '" << broadphase->get_name() << "': "
+    << pair_count << " candidate pairs (" << pair_count / ticks << " per tick), "
+    << "all pairs would be " << brute_force_pair_count << " (" << brute_force_pair_count / ticks << " per tick).\n"
+    << "Narrowphase: " << narrowphases[0]->get_sat_isa_name() << " separating axis kernel, "
+    << threads->get_thread_count() << " thread(s).\n"
+    << "Solver: " << solver.get_iterations() << " iteration(s), "
+    << warm_started_count << " of " << contact_count << " contacts warm started.\n"
+    << "Sleeping: " << asleep_body_ticks << " body ticks asleep, "
+    << skipped_ticks << " idle ticks skipped.\n";
+  if( ! unthrottled)
+    *out << "Timing: " << late_ticks << " tick(s) behind real time given up, ticks took too long to catch up.\n";
+  *out
+    << "Spawning: " << spawned_count << " objects in " << spawns.get_wave_count() << " wave(s), "
+    << spawn_time * 1000.0 / std::max(spawns.get_wave_count(), (std::size_t) 1) << " ms per wave on average, "
+    << max_spawn_time * 1000.0 << " ms at most, "
+    << spawns.get_max_waiting() << " objects waiting at most.\n";
+  if(checkpoint_writer)
+    *out
+      << "Checkpoints: " << checkpoint_writer->get_written_count() << " written to '" << checkpoint_file_name
+      << "' every " << checkpoint_interval << " ticks, " << checkpoint_writer->get_dropped_count() << " dropped, "
+      << checkpoint_time * 1000.0 / std::max(checkpoint_count, (std::size_t) 1)
+      << " ms per checkpoint on the tick thread.\n";
+  if(recorder)
+    *out
+      << "Recording: " << recorder->get_frame_count() << " frames written to '" << record_file_name
+      << "' every " << record_interval << " ticks, " << recorder->get_byte_count() << " bytes ("
+      << (double) recorder->get_byte_count() / std::max(recorder->get_body_state_count(), (uint64_t) 1) << " per body state), "
+      << recorder->get_wait_time() * 1000.0 << " ms waiting for the writer.\n";
 }
\ No newline at end of file
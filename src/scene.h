@@ -27,33 +27,49 @@ SOFTWARE.
 #pragma once
 
 #include <vector>
-#include <queue>
 #include <string>
 #include <memory>
+#include <ostream>
+#include <thread>
+#include <atomic>
 
 #include <glm/glm.hpp>
 
-#include "../simple_2d_graphics/src/window.h"
+#include "render_sink.h"
 #include "phy_object.h"
+#include "body_store.h"
+#include "contact.h"
 #include "collision.h"
+#include "contact_solver.h"
+#include "islands.h"
+#include "spawn_schedule.h"
+#include "broadphase.h"
+#include "thread_pool.h"
+#include "snapshot_buffer.h"
+#include "scene_target.h"
+#include "object_stream.h"
+#include "checkpoint.h"
+#include "trajectory.h"
 
 
 
-enum phy_obj_type{
-  triangle,
-  rectangle,
-  circle
-};
-
-
-
-class Scene{
+class Scene : public Scene_Target{
 public:
-  Scene();
+  Scene(bool headless = false);
   ~Scene();
   void set_name(const std::string& name);
   void set_background_colour(glm::vec3 colour);
   void set_time(uint time);
+  void set_broadphase(broadphase_type type);
+  void set_threads(uint thread_count);
+  void set_tick_rate(uint tick_rate);
+  void set_frame_rate(uint frame_rate);
+  void set_speed(float speed);
+  void set_unthrottled(bool unthrottled);
+  void set_output(std::ostream& out);
+  void set_show_contacts(bool show_contacts);
+  void set_solver_iterations(uint iterations);
+  void set_object_stream(std::shared_ptr< Object_Stream > stream);
   void add_object(
     glm::vec2 position,
     float rotation,
@@ -62,32 +78,103 @@ public:
     uint time,
     phy_obj_type type
   );
+  shape_id add_shape(const body_shape& shape);   // for objects prepared elsewhere (see 'Compiled_Scene')
+  void add_prepared_object(const prepared_object& obj);
+  void set_load_info(const std::string& info);   // how the scene got loaded, for the statistics
+  void set_checkpoints(uint interval, const std::string& file_name);   // every 'interval' ticks, 0 -> never
+  void load_checkpoint(const std::string& file_name);   // instead of loading a scene file
+  void set_recording(uint interval, float step, const std::string& file_name);   // every 'interval' ticks, 0 -> never. step 0 -> lossless
   void start();
+  uint get_ticks_passed();
+  double get_wall_time();
   
 private:
+  std::string name;
+  glm::vec3 background_colour = {0.0f, 0.0f, 0.0f};
   uint time;
-  std::vector< std::shared_ptr<PhyObject> > phy_objects;
-  id window_id;
+  uint tick_rate = 100;   // physics ticks per second
+  uint frame_rate = 60;   // rendered frames per second, independent of ticks
+  float step_time = 1.0f / 100.0f;   // duration of tick in seconds
+  float speed = 1.0f;   // real-time factor, 2 -> twice as fast as real time
+  bool unthrottled = false;   // ticks back to back, as fast as possible
+  double wall_time = 0.0;   // seconds spent in the loop
+  std::ostream* out;   // where reports go, scenes running concurrently each get their own
+  std::string load_info;
+  Body_Store bodies;
+  std::shared_ptr< Render_Sink > render;
+  std::vector< gobj_transform > transforms;   // handed to 'render' in one go each frame
+  Snapshot_Buffer snapshots;   // ticks -> render thread
+  std::thread render_thread;
+  std::atomic< bool > rendering = false;
+  float tick_interval = 0.0f;   // wall time seconds per tick, 0 when unthrottled
+  uint max_catch_up_time = 100000;   // microseconds of ticks run back to back when behind, more are given up
+  std::size_t late_ticks = 0;   // statistics
+  bool show_contacts = false;   // debug overlay
   uint ticks_passed = 0;
-  std::vector< std::shared_ptr< Collision > > collisions;
+  bool force_applied = false;   // test push, once per scene
+  std::shared_ptr< Thread_Pool > threads = std::make_shared<Thread_Pool>(1);
+  std::vector< std::unique_ptr< Collision > > narrowphases;   // one per thread, first one also resolves
+  std::vector< Contact_Buffer > chunk_contacts;   // one per thread
+  std::size_t min_parallel_pairs = 256;   // below this, waking threads costs more than it saves
+  Contact_Buffer contacts;   // current tick only
+  Contact_Solver solver{bodies};
+  std::size_t warm_started_count = 0;
+  std::size_t contact_count = 0;
+  Islands islands;
+  std::vector< body_pair > resting_pairs;   // candidate pairs of two sleeping bodies
+  std::size_t asleep_body_ticks = 0;
+  std::size_t skipped_ticks = 0;
+  broadphase_type broadphase_kind = bp_sweep_prune;
+  std::shared_ptr< Broadphase > broadphase = Broadphase::create(bp_sweep_prune);
+  std::vector< aabb > bounds;
+  std::vector< body_pair > candidate_pairs;
+  std::size_t pair_count = 0;   // statistics
+  std::size_t brute_force_pair_count = 0;
+  
+  Spawn_Schedule spawns;
+  std::vector< gobj_description > wave_gobjs;   // reused for every wave
+  std::vector< id > wave_gobj_ids;
+  std::size_t spawned_count = 0;   // statistics
+  double spawn_time = 0.0;   // seconds
+  double max_spawn_time = 0.0;   // slowest wave
+  std::shared_ptr< Object_Stream > stream;   // objects still in the file, null if all loaded up front
+  uint stream_lookahead = 100;   // ticks, objects are read this far ahead of their spawn
+  
+  uint checkpoint_interval = 0;   // ticks, 0 -> no checkpoints
+  std::string checkpoint_file_name;
+  uint next_checkpoint = 0;   // tick
+  uint first_tick = 0;   // the checkpoint's, when resumed
+  Checkpoint_Out checkpoint_out;   // reused, its buffer is swapped with the writer's
+  std::unique_ptr< Checkpoint_Writer > checkpoint_writer;
+  std::size_t checkpoint_count = 0;   // statistics
+  double checkpoint_time = 0.0;   // seconds the ticks spent serialising
   
-  // this mess is a priority_queue with phy_objects to be activated next on top
-  static bool compare_time(std::shared_ptr< PhyObject > phy_0, std::shared_ptr< PhyObject > phy_1){
-    return phy_0->get_time() > phy_1->get_time();   // object with biggest time value should end up on top
-  }
-  std::priority_queue<
-    std::shared_ptr< PhyObject >,   // objec type
-    std::vector< std::shared_ptr< PhyObject > >,   // container type
-    decltype(&compare_time)   // comparison function
-  > phy_objects_wait{compare_time};
+  uint record_interval = 0;   // ticks, 0 -> no trajectory
+  float record_step = 0.0f;
+  std::string record_file_name;
+  uint next_record = 0;   // tick
+  std::unique_ptr< Trajectory_Writer > recorder;
   
+  void register_gobjects();   // bodies restored from a checkpoint
   void run();
+  void start_render_thread();
+  void stop_render_thread();
   void loop_timer();
-    uint current_time();
+  void loop_unthrottled();
     void loop_tick();
+      void skip_idle_ticks();
       void check_activate_objects();
-        void activate_object(id obj_id);
-        void remove_active_objects();
+        void read_stream();
+        void activate_wave(std::span< const prepared_object > wave);
       void update_objects();
         void handle_collisions();
+          void find_candidate_pairs();
+          void detect_contacts();
+            void detect_chunk(std::size_t chunk);
+      void publish_snapshot();
+      void save_checkpoint();
+      void record_frame();
+  void loop_render();
+    void update_render(const transform_snapshot& snapshot, float alpha);
+  void print_statistics();
 };
\ No newline at end of file
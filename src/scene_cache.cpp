@@ -0,0 +1,199 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "scene_cache.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <chrono>
+#include <bit>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include "mapped_file.h"
+#include "compiled_scene.h"
+
+
+
+Scene_Cache::Scene_Cache(const std::string& directory){
+  if(directory.empty())
+    throw std::runtime_error("Scene cache needs a directory.");
+  
+  this->directory = directory;
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Scene_Cache::load(const std::string& file_name, File_Handler& handler, std::shared_ptr<Scene> scene){
+  auto time_start = std::chrono::steady_clock::now();
+  
+  // key: content only, renaming or touching a scene file still hits
+  uint64_t source_hash;
+  uint64_t source_size;
+  try{
+    Mapped_File source(file_name);
+    source_hash = hash( std::span< const char >(source.begin(), source.size()) );
+    source_size = source.size();
+  }
+  catch(std::exception& e){
+    std::cerr << "Error: " << e.what() << "\n";
+    return false;
+  }
+  std::string path = get_path(source_hash);
+  
+  // hit
+  bool hit = load_compiled(path, source_hash, source_size, *scene);
+  
+  // miss: parse, compile & keep it for next time
+  if( ! hit){
+    auto compiled = std::make_shared< Compiled_Scene >();
+    if( ! handler.process(file_name, compiled))
+      return false;
+    
+    std::vector< char > data = compiled->serialise(source_hash, source_size);
+    store(path, data);
+    Compiled_Scene::load(data, *scene);
+  }
+  
+  // statistics
+  (hit ? hit_count : miss_count)++;
+  double seconds = std::chrono::duration< double >(std::chrono::steady_clock::now() - time_start).count();
+  std::stringstream info;
+  info << "scene cache " << (hit ? "hit" : "miss") << " ('" << path << "'), " << seconds << " s.";
+  scene->set_load_info(info.str());
+  
+  return true;
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Scene_Cache::get_hit_count(){  return hit_count;  }
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Scene_Cache::get_miss_count(){  return miss_count;  }
+
+
+
+//------------------------------------------------------------------------------
+uint64_t Scene_Cache::hash(std::span< const char > data){
+  // 8 bytes per step, murmur style mixing (not cryptographic, only needs to tell scene files apart)
+  uint64_t h = 0x9e3779b97f4a7c15ULL ^ data.size();
+  std::size_t i = 0;
+  for( ; i + 8 <= data.size(); i += 8){
+    uint64_t word;
+    std::memcpy(&word, data.data() + i, sizeof(word));
+    h ^= word * 0x87c37b91114253d5ULL;
+    h = std::rotl(h, 31) * 0x4cf5ad432745937fULL;
+  }
+  for( ; i < data.size(); i++){
+    h ^= (uint8_t) data[i] * 0x87c37b91114253d5ULL;
+    h = std::rotl(h, 31) * 0x4cf5ad432745937fULL;
+  }
+  
+  // final avalanche
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  
+  return h;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////////////
+
+std::string Scene_Cache::get_path(uint64_t source_hash){
+  std::stringstream path;
+  path << directory << "/" << std::hex << std::setw(16) << std::setfill('0') << source_hash << ".cscn";
+  
+  return path.str();
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Scene_Cache::load_compiled(const std::string& path, uint64_t source_hash, uint64_t source_size, Scene& scene){
+  if( ! std::filesystem::exists(path))
+    return false;
+  
+  try{
+    Mapped_File file(path);
+    std::span< const char > data(file.begin(), file.size());
+    if( ! Compiled_Scene::is_compiled(data, source_hash, source_size))
+      return false;   // other version or hash collision, gets replaced
+    
+    Compiled_Scene::load(data, scene);
+  }
+  catch(std::exception& e){
+    std::cerr << "Warning: Ignoring cached scene '" << path << "': " << e.what() << "\n";
+    return false;
+  }
+  
+  return true;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Scene_Cache::store(const std::string& path, const std::vector< char >& data){
+  // write aside & rename, so nobody ever maps a half written file
+  static std::atomic< uint > tmp_counter = 0;
+  std::string tmp_path = path + ".tmp" + std::to_string(getpid()) + "_" + std::to_string(tmp_counter++);
+  
+  try{
+    std::filesystem::create_directories(directory);
+    
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if( ! file)
+      throw std::runtime_error("Unable to open file '" + tmp_path + "' for writing!");
+    file.write(data.data(), data.size());
+    file.close();
+    if( ! file)
+      throw std::runtime_error("Unable to write file '" + tmp_path + "'!");
+    
+    std::filesystem::rename(tmp_path, path);
+  }
+  catch(std::exception& e){
+    // the scene still runs, only the next run has to compile it again
+    std::cerr << "Warning: Unable to cache compiled scene: " << e.what() << "\n";
+    std::error_code error;
+    std::filesystem::remove(tmp_path, error);
+  }
+}
\ No newline at end of file
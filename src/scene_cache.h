@@ -0,0 +1,59 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <string>
+#include <memory>
+#include <span>
+#include <atomic>
+#include <cstdint>
+
+#include "scene.h"
+#include "file_handler.h"
+
+
+
+// compiled scenes on disk, keyed by a hash of the scene file's content (not its name or date):
+// a hit loads the prepared objects straight from the mapping, a miss parses & compiles once.
+// safe to share between scenes loading at the same time
+class Scene_Cache{
+public:
+  Scene_Cache(const std::string& directory);
+  bool load(const std::string& file_name, File_Handler& handler, std::shared_ptr<Scene> scene);   // false on error
+  std::size_t get_hit_count();
+  std::size_t get_miss_count();
+  static uint64_t hash(std::span< const char > data);
+  
+private:
+  std::string directory;
+  std::atomic< std::size_t > hit_count = 0;
+  std::atomic< std::size_t > miss_count = 0;
+  
+  std::string get_path(uint64_t source_hash);
+  bool load_compiled(const std::string& path, uint64_t source_hash, uint64_t source_size, Scene& scene);
+  void store(const std::string& path, const std::vector< char >& data);
+};
\ No newline at end of file
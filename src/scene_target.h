@@ -0,0 +1,65 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include "render_sink.h"
+#include "broadphase.h"
+
+
+
+struct object_description{   // one entry of a scene file's object array
+  glm::vec2 position;
+  float rotation;
+  float size;
+  glm::vec3 colour;
+  uint time;
+  phy_obj_type type;
+};
+
+
+
+// whatever a scene file describes gets handed to one of these (see 'File_Handler')
+class Scene_Target{
+public:
+  virtual ~Scene_Target(){}
+  virtual void set_name(const std::string& name) = 0;
+  virtual void set_background_colour(glm::vec3 colour) = 0;
+  virtual void set_time(uint time) = 0;
+  virtual void set_broadphase(broadphase_type type) = 0;
+  virtual void add_object(
+    glm::vec2 position,
+    float rotation,
+    float size,
+    glm::vec3 colour,
+    uint time,
+    phy_obj_type type
+  ) = 0;
+};
\ No newline at end of file
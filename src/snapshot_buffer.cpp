@@ -0,0 +1,48 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "snapshot_buffer.h"
+
+
+
+transform_snapshot& Snapshot_Buffer::get_back(){  return buffers[back];  }
+
+
+
+//------------------------------------------------------------------------------
+void Snapshot_Buffer::publish(){
+  back = middle.exchange(back | fresh, std::memory_order_acq_rel) & index_mask;
+}
+
+
+
+//------------------------------------------------------------------------------
+const transform_snapshot& Snapshot_Buffer::get_latest(){
+  if(middle.load(std::memory_order_relaxed) & fresh)
+    front = middle.exchange(front, std::memory_order_acq_rel) & index_mask;
+  
+  return buffers[front];
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "../simple_2d_graphics/src/graphics_object.h"
+
+
+
+// body transforms of one complete tick, plus the one before for interpolation
+struct transform_snapshot{
+  std::vector< id > gobj_ids;
+  std::vector< glm::vec2 > prev_position;
+  std::vector< glm::vec2 > position;
+  std::vector< float > prev_rotation;
+  std::vector< float > rotation;
+  std::chrono::steady_clock::time_point time;   // when the tick was published
+  float tick_interval = 0.0f;   // wall time seconds until the next tick, 0 -> don't interpolate
+  std::vector< glm::vec2 > contact_points;   // only filled with the debug overlay on
+};
+
+
+
+// triple buffer: the simulation fills 'back', swaps it with 'middle' when done,
+// the renderer swaps 'front' with 'middle' whenever there is something new,
+// neither side ever waits for the other
+class Snapshot_Buffer{
+public:
+  transform_snapshot& get_back();   // simulation thread only
+  void publish();   // simulation thread only
+  const transform_snapshot& get_latest();   // render thread only
+  
+private:
+  static constexpr uint8_t index_mask = 3;
+  static constexpr uint8_t fresh = 4;   // 'middle' holds a tick the renderer hasn't taken yet
+  
+  transform_snapshot buffers[3];
+  std::atomic< uint8_t > middle = 1;
+  uint8_t back = 0;
+  uint8_t front = 2;
+};
\ No newline at end of file
@@ -0,0 +1,183 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "spawn_schedule.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+
+void Spawn_Schedule::add(const prepared_object& obj){
+  if(built)
+    append(obj);
+  else
+    objects.push_back(obj);
+  
+  max_waiting = std::max(max_waiting, objects.size() - (built ? wave_begin[next_wave] : 0));
+}
+
+
+
+//------------------------------------------------------------------------------
+void Spawn_Schedule::build(){
+  if(built)
+    return;   // restored from a checkpoint
+  
+  // same tick -> file order
+  std::stable_sort(objects.begin(), objects.end(), [](auto& obj_0, auto& obj_1){
+    return obj_0.time < obj_1.time;
+  });
+  
+  group_waves();
+  wave_count = wave_ticks.size();
+  built = true;
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Spawn_Schedule::empty(){  return next_wave >= wave_ticks.size();  }
+
+
+
+//------------------------------------------------------------------------------
+uint Spawn_Schedule::get_next_tick(){  return wave_ticks[next_wave];  }
+
+
+
+//------------------------------------------------------------------------------
+std::span< const prepared_object > Spawn_Schedule::take_due(uint tick){
+  compact();   // the span handed out last time is done with
+  
+  std::size_t first_wave = next_wave;
+  while( ! empty() && get_next_tick() <= tick)
+    next_wave++;
+  
+  std::size_t begin = wave_begin[first_wave];
+  return std::span< const prepared_object >(objects).subspan(begin, wave_begin[next_wave] - begin);
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Spawn_Schedule::get_wave_count(){  return wave_count;  }
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Spawn_Schedule::get_max_waiting(){  return max_waiting;  }
+
+
+
+//------------------------------------------------------------------------------
+void Spawn_Schedule::save(Checkpoint_Out& out){
+  // waiting objects only, already spawned ones are bodies now
+  std::size_t begin = built ? wave_begin[next_wave] : 0;
+  out.write_array( std::vector< prepared_object >(objects.begin() + begin, objects.end()) );
+  out.write_value< uint64_t >(wave_count);
+  out.write_value< uint64_t >(max_waiting);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Spawn_Schedule::load(Checkpoint_In& in, std::span< const body_shape > shapes){
+  in.read_array(objects);
+  wave_count = in.read_value< uint64_t >();
+  max_waiting = in.read_value< uint64_t >();
+  
+  // saved in spawn order, shapes are looked up once they spawn
+  for(std::size_t i = 0; i < objects.size(); i++){
+    if(i > 0 && objects[i].time < objects[i - 1].time)
+      throw std::runtime_error("Invalid checkpoint! Objects to spawn are out of order.");
+    if(objects[i].type > circle || objects[i].shape >= shapes.size() || shapes[ objects[i].shape ].type != objects[i].type)
+      throw std::runtime_error("Invalid checkpoint! Object to spawn has a broken shape or type.");
+  }
+  
+  group_waves();
+  built = true;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+void Spawn_Schedule::group_waves(){
+  wave_ticks.clear();
+  wave_begin.clear();
+  for(std::size_t i = 0; i < objects.size(); i++){
+    if(i > 0 && objects[i].time == wave_ticks.back())
+      continue;
+    
+    wave_ticks.push_back( objects[i].time );
+    wave_begin.push_back(i);
+  }
+  wave_begin.push_back( objects.size() );
+  next_wave = 0;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Spawn_Schedule::append(const prepared_object& obj){
+  uint tick = obj.time;
+  if( ! wave_ticks.empty() && tick < wave_ticks.back())
+    throw std::runtime_error("Spawn_Schedule: objects added after 'build()' have to be in spawn order.");
+  
+  objects.push_back(obj);
+  
+  // same tick as the last wave and that one is still waiting -> join it
+  if( ! wave_ticks.empty() && tick == wave_ticks.back() && next_wave < wave_ticks.size()){
+    wave_begin.back() = objects.size();
+    return;
+  }
+  
+  wave_ticks.push_back(tick);
+  wave_begin.push_back( objects.size() );
+  wave_count++;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Spawn_Schedule::compact(){
+  // drop spawned objects once they make up half of the vector -> amortised O(1)
+  std::size_t spawned = wave_begin[next_wave];
+  if(spawned == 0 || spawned < objects.size() - spawned)
+    return;
+  
+  objects.erase(objects.begin(), objects.begin() + spawned);
+  wave_ticks.erase(wave_ticks.begin(), wave_ticks.begin() + next_wave);
+  wave_begin.erase(wave_begin.begin(), wave_begin.begin() + next_wave);
+  for(auto& begin : wave_begin)
+    begin -= spawned;
+  next_wave = 0;
+}
\ No newline at end of file
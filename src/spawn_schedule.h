@@ -0,0 +1,61 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <span>
+
+#include "body_store.h"
+
+
+
+// objects waiting to be spawned, grouped into one wave per spawn tick
+class Spawn_Schedule{
+public:
+  void add(const prepared_object& obj);   // any order before 'build()', spawn order after it
+  void build();   // once the initial load is done, nothing to do after 'load()'
+  bool empty();   // nothing left to spawn
+  uint get_next_tick();   // of the next wave, only valid if not 'empty()'
+  std::span< const prepared_object > take_due(uint tick);   // every wave up to 'tick'
+  std::size_t get_wave_count();
+  std::size_t get_max_waiting();   // most objects held at once
+  void save(Checkpoint_Out& out);
+  void load(Checkpoint_In& in, std::span< const body_shape > shapes);   // replaces everything, built afterwards. 'shapes' restored before
+  
+private:
+  std::vector< prepared_object > objects;   // sorted by spawn tick once built
+  std::vector< uint > wave_ticks;
+  std::vector< std::size_t > wave_begin;   // into 'objects', one extra at the end
+  std::size_t next_wave = 0;
+  bool built = false;
+  std::size_t wave_count = 0;
+  std::size_t max_waiting = 0;
+  
+  void group_waves();
+  void append(const prepared_object& obj);
+  void compact();
+};
\ No newline at end of file
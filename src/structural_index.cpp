@@ -0,0 +1,270 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "structural_index.h"
+
+#include <array>
+#include <exception>
+#include <stdexcept>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #define SCAN_X86
+  #include <immintrin.h>
+#endif
+
+
+
+// per char: 1 token char, 2 structural char as well
+static constexpr std::array< uint8_t, 256 > char_classes = [](){
+  std::array< uint8_t, 256 > classes{};
+  for(int c = 0; c < 256; c++){
+    bool alnum = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    if(alnum || c == '.' || c == '-')
+      classes[c] = 1;
+  }
+  for(char c : {'{', '}', '[', ']', ':', ',', '"'})
+    classes[(uint8_t) c] = 3;
+  
+  return classes;
+}();
+
+
+
+#ifdef SCAN_X86
+// one byte per char, 0xff where it holds
+static inline __m128i eq_sse(__m128i c, char value){
+  return _mm_cmpeq_epi8(c, _mm_set1_epi8(value));
+}
+
+static inline __m128i in_range_sse(__m128i c, char low, char high){
+  return _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8(low - 1)), _mm_cmpgt_epi8(_mm_set1_epi8(high + 1), c));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i eq_avx2(__m256i c, char value){
+  return _mm256_cmpeq_epi8(c, _mm256_set1_epi8(value));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i in_range_avx2(__m256i c, char low, char high){
+  return _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8(low - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), c));
+}
+#endif
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// public
+////////////////////////////////////////////////////////////////////////////////
+
+Structural_Index::Structural_Index()
+  : Structural_Index(detect_isa()){}
+
+
+
+//------------------------------------------------------------------------------
+Structural_Index::Structural_Index(scan_isa isa){
+  this->isa = isa;
+}
+
+
+
+//------------------------------------------------------------------------------
+scan_isa Structural_Index::get_isa(){  return isa;  }
+
+
+
+//------------------------------------------------------------------------------
+void Structural_Index::set_isa(scan_isa isa){
+  this->isa = isa;
+}
+
+
+
+//------------------------------------------------------------------------------
+std::string Structural_Index::get_isa_name(scan_isa isa){
+  switch(isa){
+    case scan_scalar: return "scalar";
+    case scan_sse:    return "sse";
+    case scan_avx2:   return "avx2";
+    default: throw std::runtime_error("Invalid instruction set");
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+scan_isa Structural_Index::detect_isa(){
+  #ifdef SCAN_X86
+    if( __builtin_cpu_supports("avx2") )
+      return scan_avx2;
+    if( __builtin_cpu_supports("sse2") )
+      return scan_sse;
+  #endif
+  
+  return scan_scalar;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Structural_Index::build(const char* begin, const char* end, bool in_token){
+  std::size_t size = end - begin;
+  if(size > std::numeric_limits< uint32_t >::max())
+    throw std::runtime_error("Structural_Index: Cannot index more than 4 GiB at once.");
+  
+  // worst case: every char starts a token
+  if(positions.size() < size)
+    positions.resize(size);
+  count = 0;
+  
+  // whole blocks first, the rest char by char
+  std::size_t done = 0;
+  switch(isa){
+    case scan_avx2: done = build_avx2(begin, end, in_token); break;
+    case scan_sse:  done = build_sse(begin, end, in_token); break;
+    default: break;
+  }
+  build_scalar(begin + done, end, done, in_token);
+}
+
+
+
+//------------------------------------------------------------------------------
+std::span< const uint32_t > Structural_Index::get_positions(){
+  return std::span< const uint32_t >(positions.data(), count);
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Structural_Index::is_token_char(char c){  return char_classes[(uint8_t) c] != 0;  }
+
+
+
+//------------------------------------------------------------------------------
+bool Structural_Index::is_structural(char c){  return char_classes[(uint8_t) c] == 3;  }
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////////////
+
+void Structural_Index::build_scalar(const char* begin, const char* end, std::size_t offset, bool& in_token){
+  for(const char* c = begin; c < end; c++, offset++){
+    uint8_t char_class = char_classes[(uint8_t) *c];
+    
+    // structural chars always start a token, others only after a gap
+    if(char_class == 3 || (char_class == 1 && ! in_token))
+      positions[count++] = offset;
+    in_token = char_class == 1;
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Structural_Index::build_sse(const char* begin, const char* end, bool& in_token){
+  #ifdef SCAN_X86
+    std::size_t size = end - begin;
+    std::size_t i = 0;
+    uint32_t carry = in_token;
+    
+    for( ; i + 16 <= size; i += 16){
+      __m128i c = _mm_loadu_si128((const __m128i*) (begin + i));
+      
+      // one bit per char
+      __m128i structural = _mm_or_si128(
+        _mm_or_si128( _mm_or_si128(eq_sse(c, '{'), eq_sse(c, '}')), _mm_or_si128(eq_sse(c, '['), eq_sse(c, ']')) ),
+        _mm_or_si128( _mm_or_si128(eq_sse(c, ':'), eq_sse(c, ',')), eq_sse(c, '"') )
+      );
+      __m128i word = _mm_or_si128(
+        _mm_or_si128( in_range_sse(c, '0', '9'), in_range_sse(_mm_or_si128(c, _mm_set1_epi8(0x20)), 'a', 'z') ),   // | 0x20 -> lower case
+        _mm_or_si128( eq_sse(c, '.'), eq_sse(c, '-') )
+      );
+      uint32_t structural_bits = _mm_movemask_epi8(structural);
+      uint32_t word_bits = _mm_movemask_epi8(word);
+      
+      // same rule as 'build_scalar()', for 16 chars at once
+      add_positions(structural_bits | (word_bits & ~((word_bits << 1) | carry)), i);
+      carry = (word_bits >> 15) & 1;
+    }
+    
+    in_token = carry;
+    return i;
+  #else
+    return 0;
+  #endif
+}
+
+
+
+//------------------------------------------------------------------------------
+#ifdef SCAN_X86
+__attribute__((target("avx2")))
+#endif
+std::size_t Structural_Index::build_avx2(const char* begin, const char* end, bool& in_token){
+  #ifdef SCAN_X86
+    std::size_t size = end - begin;
+    std::size_t i = 0;
+    uint32_t carry = in_token;
+    
+    for( ; i + 32 <= size; i += 32){
+      __m256i c = _mm256_loadu_si256((const __m256i*) (begin + i));
+      
+      // one bit per char
+      __m256i structural = _mm256_or_si256(
+        _mm256_or_si256( _mm256_or_si256(eq_avx2(c, '{'), eq_avx2(c, '}')), _mm256_or_si256(eq_avx2(c, '['), eq_avx2(c, ']')) ),
+        _mm256_or_si256( _mm256_or_si256(eq_avx2(c, ':'), eq_avx2(c, ',')), eq_avx2(c, '"') )
+      );
+      __m256i word = _mm256_or_si256(
+        _mm256_or_si256( in_range_avx2(c, '0', '9'), in_range_avx2(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), 'a', 'z') ),   // | 0x20 -> lower case
+        _mm256_or_si256( eq_avx2(c, '.'), eq_avx2(c, '-') )
+      );
+      uint32_t structural_bits = _mm256_movemask_epi8(structural);
+      uint32_t word_bits = _mm256_movemask_epi8(word);
+      
+      // same rule as 'build_scalar()', for 32 chars at once
+      add_positions(structural_bits | (word_bits & ~((word_bits << 1) | carry)), i);
+      carry = word_bits >> 31;
+    }
+    
+    in_token = carry;
+    return i;
+  #else
+    return 0;
+  #endif
+}
+
+
+
+//------------------------------------------------------------------------------
+void Structural_Index::add_positions(uint64_t starts, std::size_t offset){
+  for( ; starts != 0; starts &= starts - 1)
+    positions[count++] = offset + __builtin_ctzll(starts);
+}
\ No newline at end of file
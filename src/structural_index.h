@@ -0,0 +1,68 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <span>
+#include <string>
+#include <cstdint>
+
+
+
+enum scan_isa{
+  scan_scalar,
+  scan_sse,
+  scan_avx2
+};
+
+
+
+// first pass over scene text: finds where tokens start (structural chars '{}[]:,"' and
+// the first char of numbers & words), so the parser can jump over whitespace
+class Structural_Index{
+public:
+  Structural_Index();   // fastest instruction set supported by this cpu
+  Structural_Index(scan_isa isa);
+  scan_isa get_isa();
+  void set_isa(scan_isa isa);
+  static std::string get_isa_name(scan_isa isa);
+  static scan_isa detect_isa();
+  void build(const char* begin, const char* end, bool in_token);   // 'in_token': the char before 'begin' continues a number / word
+  std::span< const uint32_t > get_positions();   // offsets from 'begin', ascending
+  static bool is_token_char(char c);   // anything the parser doesn't skip
+  static bool is_structural(char c);
+  
+private:
+  scan_isa isa;
+  std::vector< uint32_t > positions;   // only grows, 'count' are valid
+  std::size_t count = 0;
+  
+  void build_scalar(const char* begin, const char* end, std::size_t offset, bool& in_token);
+  std::size_t build_sse(const char* begin, const char* end, bool& in_token);
+  std::size_t build_avx2(const char* begin, const char* end, bool& in_token);
+  void add_positions(uint64_t starts, std::size_t offset);
+};
\ No newline at end of file
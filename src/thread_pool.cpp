@@ -0,0 +1,142 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "thread_pool.h"
+
+#include <utility>
+
+
+
+Thread_Pool::Thread_Pool(uint thread_count){
+  for(uint i = 1; i < thread_count; i++)
+    workers.emplace_back( &Thread_Pool::work, this );
+}
+
+
+
+//------------------------------------------------------------------------------
+Thread_Pool::~Thread_Pool(){
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  start_signal.notify_all();
+  
+  for(auto &w : workers)
+    w.join();
+}
+
+
+
+//------------------------------------------------------------------------------
+uint Thread_Pool::get_thread_count(){  return workers.size() + 1;  }
+
+
+
+//------------------------------------------------------------------------------
+void Thread_Pool::run(std::size_t task_count, const std::function< void(std::size_t task) >& task){
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &task;
+    this->task_count = task_count;
+    next_task = 0;
+    done_tasks = 0;
+    error = nullptr;
+    generation++;
+  }
+  start_signal.notify_all();
+  
+  std::size_t done = take_tasks(task, task_count);
+  
+  // wait for stragglers, no worker may still hold 'task' once we return
+  std::unique_lock<std::mutex> lock(mutex);
+  done_tasks += done;
+  done_signal.wait(lock, [&](){  return done_tasks == task_count && busy_workers == 0;  });
+  job = nullptr;
+  
+  // on the calling thread, where someone can catch it
+  if(error)
+    std::rethrow_exception( std::exchange(error, nullptr) );
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////////////
+
+void Thread_Pool::work(){
+  uint seen_generation = 0;
+  
+  while(true){
+    const std::function< void(std::size_t) >* current_job;
+    std::size_t count;
+    
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      start_signal.wait(lock, [&](){  return stopping || generation != seen_generation;  });
+      if(stopping)
+        return;
+      
+      seen_generation = generation;
+      if(job == nullptr)   // woke up too late, already finished
+        continue;
+      
+      current_job = job;
+      count = task_count;
+      busy_workers++;
+    }
+    
+    std::size_t done = take_tasks(*current_job, count);
+    
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      done_tasks += done;
+      busy_workers--;
+    }
+    done_signal.notify_all();
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+std::size_t Thread_Pool::take_tasks(const std::function< void(std::size_t) >& task, std::size_t count){
+  std::size_t done = 0;
+  
+  for(std::size_t t = next_task++; t < count; t = next_task++){
+    // a worker thread has no one to throw to, the other tasks still run so 'run()' can wait for them
+    try{  task(t);  }
+    catch(...){
+      std::lock_guard<std::mutex> lock(mutex);
+      if( ! error)
+        error = std::current_exception();
+    }
+    done++;
+  }
+  
+  return done;
+}
\ No newline at end of file
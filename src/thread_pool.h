@@ -0,0 +1,66 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+
+
+// fixed set of workers, the calling thread helps out while it waits
+class Thread_Pool{
+public:
+  Thread_Pool(uint thread_count);   // including the calling thread
+  ~Thread_Pool();
+  uint get_thread_count();
+  void run(   // returns once every task is done, rethrows the first exception a task threw
+    std::size_t task_count,
+    const std::function< void(std::size_t task) >& task
+  );
+  
+private:
+  std::vector< std::thread > workers;
+  std::mutex mutex;
+  std::condition_variable start_signal;
+  std::condition_variable done_signal;
+  const std::function< void(std::size_t) >* job = nullptr;
+  std::size_t task_count = 0;
+  std::atomic< std::size_t > next_task = 0;
+  std::size_t done_tasks = 0;
+  uint busy_workers = 0;
+  uint generation = 0;
+  bool stopping = false;
+  std::exception_ptr error;   // first one of the current 'run()'
+  
+  void work();
+  std::size_t take_tasks(const std::function< void(std::size_t) >& task, std::size_t count);
+};
\ No newline at end of file
@@ -0,0 +1,563 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+#include "trajectory.h"
+
+#include <iostream>
+#include <sstream>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cmath>
+using namespace std::chrono;
+
+
+
+Trajectory_Codec::Trajectory_Codec(float step){
+  this->step = step;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Trajectory_Codec::encode(const trajectory_frame& frame, uint32_t frame_number, bool keyframe, std::vector< uint8_t >& data){
+  data.clear();
+  std::size_t n = frame.ids.size();
+  
+  // ids, mostly counting up by one
+  body_id prev_id = 0;
+  for(std::size_t i = 0; i < n; i++){
+    write_varint(zigzag( (int64_t) frame.ids[i] - prev_id ), data);
+    prev_id = frame.ids[i];
+    resize(prev_id);
+  }
+  
+  // one channel after the other, a sleeping body costs a byte per value
+  for(std::size_t c = 0; c < channel_count; c++)
+    for(std::size_t i = 0; i < n; i++){
+      body_id id = frame.ids[i];
+      uint64_t code = to_code( get_channel(frame, c, i) );
+      uint64_t base = ! keyframe && seen[id] == frame_number ? previous[id][c] : 0;
+      write_varint(delta(code, base), data);
+      previous[id][c] = code;
+    }
+  
+  for(auto &id : frame.ids)
+    seen[id] = frame_number + 1;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Trajectory_Codec::decode(std::span< const uint8_t > data, uint32_t frame_number, bool keyframe, trajectory_frame& frame){
+  std::size_t n = frame.ids.size();
+  frame.position.resize(n);
+  frame.rotation.resize(n);
+  frame.velocity.resize(n);
+  frame.angular_velocity.resize(n);
+  
+  std::size_t pos = 0;
+  int64_t id = 0;
+  for(std::size_t i = 0; i < n; i++){
+    id += unzigzag( read_varint(data, pos) );
+    if(id < 0 || id >= max_body_id)
+      throw std::runtime_error("Invalid trajectory! Body id out of range.");
+    frame.ids[i] = id;
+    resize(id);
+  }
+  
+  for(std::size_t c = 0; c < channel_count; c++)
+    for(std::size_t i = 0; i < n; i++){
+      body_id id = frame.ids[i];
+      uint64_t base = ! keyframe && seen[id] == frame_number ? previous[id][c] : 0;
+      uint64_t code = undelta(read_varint(data, pos), base);
+      set_channel(frame, c, i, from_code(code));
+      previous[id][c] = code;
+    }
+  
+  for(auto &id : frame.ids)
+    seen[id] = frame_number + 1;
+  
+  if(pos != data.size())
+    throw std::runtime_error("Invalid trajectory! Frame size doesn't match its data.");
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// codec, private
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t Trajectory_Codec::to_code(float value){
+  // lossless: bits of a value that barely changed differ in the low bits only
+  if(step == 0.0f){
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+  
+  double q = std::round( (double) value / step );
+  if( !(std::fabs(q) < 1e15) )
+    q = 0.0;   // nan & inf, nothing sensible to round to
+  return (uint64_t) (int64_t) q;
+}
+
+
+
+//------------------------------------------------------------------------------
+float Trajectory_Codec::from_code(uint64_t code){
+  if(step == 0.0f){
+    uint32_t bits = code;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+  
+  return (int64_t) code * (double) step;
+}
+
+
+
+//------------------------------------------------------------------------------
+uint64_t Trajectory_Codec::delta(uint64_t code, uint64_t previous){
+  if(step == 0.0f)
+    return code ^ previous;
+  
+  return zigzag( (int64_t) (code - previous) );
+}
+
+
+
+//------------------------------------------------------------------------------
+uint64_t Trajectory_Codec::undelta(uint64_t delta, uint64_t previous){
+  if(step == 0.0f)
+    return (delta ^ previous) & 0xFFFFFFFF;
+  
+  return previous + (uint64_t) unzigzag(delta);
+}
+
+
+
+//------------------------------------------------------------------------------
+void Trajectory_Codec::resize(body_id id){
+  if(id < previous.size())
+    return;
+  
+  previous.resize(id + 1);
+  seen.resize(id + 1, 0);
+}
+
+
+
+//------------------------------------------------------------------------------
+float Trajectory_Codec::get_channel(const trajectory_frame& frame, std::size_t c, std::size_t i){
+  switch(c){
+    case 0: return frame.position[i].x;
+    case 1: return frame.position[i].y;
+    case 2: return frame.rotation[i];
+    case 3: return frame.velocity[i].x;
+    case 4: return frame.velocity[i].y;
+    default: return frame.angular_velocity[i];
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Trajectory_Codec::set_channel(trajectory_frame& frame, std::size_t c, std::size_t i, float value){
+  switch(c){
+    case 0: frame.position[i].x = value; break;
+    case 1: frame.position[i].y = value; break;
+    case 2: frame.rotation[i] = value; break;
+    case 3: frame.velocity[i].x = value; break;
+    case 4: frame.velocity[i].y = value; break;
+    default: frame.angular_velocity[i] = value;
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Trajectory_Codec::write_varint(uint64_t value, std::vector< uint8_t >& data){
+  while(value >= 0x80){
+    data.push_back( (value & 0x7F) | 0x80 );
+    value >>= 7;
+  }
+  data.push_back(value);
+}
+
+
+
+//------------------------------------------------------------------------------
+uint64_t Trajectory_Codec::read_varint(std::span< const uint8_t > data, std::size_t& pos){
+  uint64_t value = 0;
+  for(uint shift = 0; shift < 64; shift += 7){
+    if(pos >= data.size())
+      throw std::runtime_error("Invalid trajectory! Frame data reaches past its end.");
+    
+    uint8_t byte = data[pos++];
+    value |= (uint64_t) (byte & 0x7F) << shift;
+    if( !(byte & 0x80) )
+      return value;
+  }
+  
+  throw std::runtime_error("Invalid trajectory! Number too long.");
+}
+
+
+
+//------------------------------------------------------------------------------
+uint64_t Trajectory_Codec::zigzag(int64_t value){
+  // small negative & positive numbers -> small unsigned ones
+  return ( (uint64_t) value << 1 ) ^ (uint64_t) (value >> 63);
+}
+
+
+
+//------------------------------------------------------------------------------
+int64_t Trajectory_Codec::unzigzag(uint64_t value){
+  return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// writer
+////////////////////////////////////////////////////////////////////////////////
+
+Trajectory_Writer::Trajectory_Writer(const std::string& file_name, uint interval, float step)
+  : file_name(file_name), codec(step){
+  file.open(file_name, std::ios::binary | std::ios::trunc);
+  if( ! file)
+    throw std::runtime_error("Unable to open file '" + file_name + "' for writing!");
+  
+  std::memcpy(header.magic, magic, sizeof(header.magic));
+  header.endian_marker = endian_marker;
+  header.version = version;
+  header.header_size = sizeof(trajectory_header);
+  header.interval = interval;
+  header.keyframe_interval = keyframe_interval;
+  header.quantised = step > 0.0f;
+  header.step = step;
+  file.write( (const char*) &header, sizeof(header) );   // again with counts & index once finished
+  byte_count = sizeof(header);
+  
+  for(auto &f : frames)
+    free_frames.push_back(&f);
+  thread = std::thread(&Trajectory_Writer::work, this);
+}
+
+
+
+//------------------------------------------------------------------------------
+Trajectory_Writer::~Trajectory_Writer(){
+  finish();
+}
+
+
+
+//------------------------------------------------------------------------------
+trajectory_frame& Trajectory_Writer::get_frame(){
+  std::unique_lock<std::mutex> lock(mutex);
+  if(free_frames.empty()){
+    auto time_start = steady_clock::now();
+    free_signal.wait(lock, [this](){  return ! free_frames.empty();  });
+    wait_time += duration< double >(steady_clock::now() - time_start).count();
+  }
+  
+  filling = free_frames.front();
+  free_frames.pop_front();
+  return *filling;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Trajectory_Writer::push(){
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queued.push_back(filling);
+    filling = nullptr;
+  }
+  queued_signal.notify_one();
+}
+
+
+
+//------------------------------------------------------------------------------
+void Trajectory_Writer::finish(){
+  if( ! thread.joinable())
+    return;
+  
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  queued_signal.notify_one();
+  thread.join();
+  
+  write_index();
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Trajectory_Writer::is_ok(){  return ok;  }
+
+
+
+//------------------------------------------------------------------------------
+uint32_t Trajectory_Writer::get_frame_count(){  return header.frame_count;  }
+
+
+
+//------------------------------------------------------------------------------
+uint64_t Trajectory_Writer::get_byte_count(){  return byte_count;  }
+
+
+
+//------------------------------------------------------------------------------
+uint64_t Trajectory_Writer::get_body_state_count(){  return body_state_count;  }
+
+
+
+//------------------------------------------------------------------------------
+double Trajectory_Writer::get_wait_time(){  return wait_time;  }
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// writer, private
+////////////////////////////////////////////////////////////////////////////////
+
+void Trajectory_Writer::work(){
+  while(true){
+    trajectory_frame* frame;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      queued_signal.wait(lock, [this](){  return ! queued.empty() || stopping;  });
+      if(queued.empty())
+        return;   // stopping, nothing left
+      
+      frame = queued.front();
+      queued.pop_front();
+    }
+    
+    write_frame(*frame);
+    
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      free_frames.push_back(frame);
+    }
+    free_signal.notify_one();
+  }
+}
+
+
+
+//------------------------------------------------------------------------------
+void Trajectory_Writer::write_frame(const trajectory_frame& frame){
+  if( ! ok)
+    return;
+  
+  uint32_t frame_number = header.frame_count;
+  bool keyframe = frame_number % keyframe_interval == 0;
+  codec.encode(frame, frame_number, keyframe, encoded);
+  if(keyframe)
+    keyframes.push_back( {frame.tick, frame_number, byte_count} );
+  
+  trajectory_frame_header frame_header = {frame.tick, (uint32_t) frame.ids.size(), keyframe, (uint32_t) encoded.size()};
+  file.write( (const char*) &frame_header, sizeof(frame_header) );
+  file.write( (const char*) encoded.data(), encoded.size() );
+  if( ! file){
+    // no one to throw to on this thread, the simulation goes on
+    std::cerr << "Warning: Unable to write trajectory '" << file_name << "', recording stopped.\n";
+    ok = false;
+    return;
+  }
+  
+  byte_count += sizeof(frame_header) + encoded.size();
+  body_state_count += frame.ids.size();
+  header.frame_count++;
+}
+
+
+
+//------------------------------------------------------------------------------
+void Trajectory_Writer::write_index(){
+  if( ! ok)
+    return;
+  
+  header.index_offset = byte_count;
+  header.keyframe_count = keyframes.size();
+  file.write( (const char*) keyframes.data(), keyframes.size() * sizeof(trajectory_keyframe) );
+  file.seekp(0);
+  file.write( (const char*) &header, sizeof(header) );
+  file.close();
+  if( ! file){
+    std::cerr << "Warning: Unable to finish trajectory '" << file_name << "'.\n";
+    ok = false;
+    return;
+  }
+  
+  byte_count += keyframes.size() * sizeof(trajectory_keyframe);
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// reader
+////////////////////////////////////////////////////////////////////////////////
+
+Trajectory_Reader::Trajectory_Reader(const std::string& file_name)
+  : file(file_name), header( read_header(file) ), codec(header.quantised ? header.step : 0.0f){
+  // index at the end
+  if(header.index_offset == 0)
+    throw std::runtime_error("Invalid trajectory! Recording didn't finish, there is no keyframe index.");
+  if(header.index_offset < sizeof(header) || header.index_offset > file.size()
+    || (file.size() - header.index_offset) != header.keyframe_count * sizeof(trajectory_keyframe))
+    throw std::runtime_error("Invalid trajectory! Keyframe index doesn't fit the file.");
+  
+  keyframes.resize(header.keyframe_count);
+  std::memcpy(keyframes.data(), file.begin() + header.index_offset, keyframes.size() * sizeof(trajectory_keyframe));
+  for(std::size_t k = 0; k < keyframes.size(); k++)
+    if(keyframes[k].offset < sizeof(header) || keyframes[k].offset >= header.index_offset || keyframes[k].frame >= header.frame_count
+      || (k > 0 && keyframes[k].tick < keyframes[k - 1].tick))
+      throw std::runtime_error("Invalid trajectory! Keyframe index is broken.");
+  
+  pos = sizeof(header);
+}
+
+
+
+//------------------------------------------------------------------------------
+uint Trajectory_Reader::get_interval(){  return header.interval;  }
+
+
+
+//------------------------------------------------------------------------------
+bool Trajectory_Reader::is_quantised(){  return header.quantised;  }
+
+
+
+//------------------------------------------------------------------------------
+float Trajectory_Reader::get_step(){  return header.step;  }
+
+
+
+//------------------------------------------------------------------------------
+uint32_t Trajectory_Reader::get_frame_count(){  return header.frame_count;  }
+
+
+
+//------------------------------------------------------------------------------
+bool Trajectory_Reader::read_at(uint tick, trajectory_frame& frame){
+  // closest keyframe before, decode on from there
+  auto keyframe = std::upper_bound(keyframes.begin(), keyframes.end(), tick, [](uint tick, const trajectory_keyframe& k){
+    return tick < k.tick;
+  });
+  if(keyframe == keyframes.begin())
+    return false;
+  keyframe--;
+  
+  pos = keyframe->offset;
+  frame_number = keyframe->frame;
+  if( ! peek().keyframe)
+    throw std::runtime_error("Invalid trajectory! Index points to a frame that is no keyframe.");
+  
+  read(frame);
+  while(frame_number < header.frame_count && peek().tick <= tick)
+    read(frame);
+  
+  return true;
+}
+
+
+
+//------------------------------------------------------------------------------
+bool Trajectory_Reader::read(trajectory_frame& frame){
+  if(frame_number >= header.frame_count)
+    return false;
+  
+  trajectory_frame_header frame_header = peek();
+  if(frame_number == 0 && ! frame_header.keyframe)
+    throw std::runtime_error("Invalid trajectory! First frame is no keyframe.");
+  if(frame_header.body_count > frame_header.size)
+    throw std::runtime_error("Invalid trajectory! More bodies than the frame has data for.");
+  
+  frame.tick = frame_header.tick;
+  frame.ids.resize(frame_header.body_count);
+  auto data = (const uint8_t*) file.begin() + pos + sizeof(frame_header);
+  codec.decode( {data, frame_header.size}, frame_number, frame_header.keyframe, frame );
+  
+  pos += sizeof(frame_header) + frame_header.size;
+  frame_number++;
+  return true;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// reader, private
+////////////////////////////////////////////////////////////////////////////////
+
+trajectory_header Trajectory_Reader::read_header(Mapped_File& file){
+  trajectory_header header;
+  if(file.size() < sizeof(header))
+    throw std::runtime_error("Invalid trajectory! File too small for header.");
+  std::memcpy(&header, file.begin(), sizeof(header));
+  
+  if(std::memcmp(header.magic, Trajectory_Writer::magic, sizeof(header.magic)) != 0)
+    throw std::runtime_error("Invalid trajectory! Not a trajectory file.");
+  if(header.endian_marker != Trajectory_Writer::endian_marker)
+    throw std::runtime_error("Invalid trajectory! Written on a machine with other byte order.");
+  if(header.version != Trajectory_Writer::version){
+    std::stringstream message;
+    message << "Invalid trajectory! Version " << header.version << " is not supported (expected " << Trajectory_Writer::version << ").";
+    throw std::runtime_error(message.str());
+  }
+  if(header.header_size != sizeof(trajectory_header))
+    throw std::runtime_error("Invalid trajectory! Header size does not match.");
+  if(header.quantised && !(header.step > 0.0f))
+    throw std::runtime_error("Invalid trajectory! Quantized without a step.");
+  
+  return header;
+}
+
+
+
+//------------------------------------------------------------------------------
+trajectory_frame_header Trajectory_Reader::peek(){
+  trajectory_frame_header frame_header;
+  if(pos > header.index_offset || header.index_offset - pos < sizeof(frame_header))
+    throw std::runtime_error("Invalid trajectory! Frame reaches into the index.");
+  std::memcpy(&frame_header, file.begin() + pos, sizeof(frame_header));
+  if(frame_header.size > header.index_offset - pos - sizeof(frame_header))
+    throw std::runtime_error("Invalid trajectory! Frame reaches into the index.");
+  
+  return frame_header;
+}
\ No newline at end of file
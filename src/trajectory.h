@@ -0,0 +1,197 @@
+/*
+
+MIT License
+
+Copyright (c) 2022 the_green_penguin
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+#pragma once
+
+#include <vector>
+#include <string>
+#include <span>
+#include <array>
+#include <deque>
+#include <memory>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "body_store.h"
+#include "mapped_file.h"
+
+
+
+// trajectory file, version 1:
+//   header | frame ... | keyframe index
+// a frame is a 'trajectory_frame_header' & its encoded body states. every value is stored as the
+// difference to the same body's value in the frame before (varint), keyframes & new bodies against 0,
+// so a reader can start decoding at any keyframe. all numbers in the byte order of the machine that wrote it
+struct trajectory_header{
+  char magic[8];   // "2DPHYTRJ"
+  uint32_t endian_marker;   // 0x01020304
+  uint32_t version;
+  uint32_t header_size;
+  uint32_t interval;   // ticks between frames
+  uint32_t keyframe_interval;   // frames between keyframes
+  uint32_t quantised;   // 0 -> lossless
+  float step;   // quantised only, values are rounded to multiples of it
+  uint32_t frame_count;
+  uint64_t index_offset;   // 0 -> recording didn't finish, no index
+  uint64_t keyframe_count;
+};
+
+struct trajectory_frame_header{
+  uint32_t tick;
+  uint32_t body_count;
+  uint32_t keyframe;   // 1 -> decodes on its own
+  uint32_t size;   // encoded bytes after this header
+};
+
+struct trajectory_keyframe{   // index entry
+  uint32_t tick;
+  uint32_t frame;
+  uint64_t offset;   // of its 'trajectory_frame_header' in the file
+};
+
+
+
+// body states of one tick, dense order
+struct trajectory_frame{
+  uint tick = 0;
+  std::vector< body_id > ids;
+  std::vector< glm::vec2 > position;
+  std::vector< float > rotation;
+  std::vector< glm::vec2 > velocity;
+  std::vector< float > angular_velocity;
+};
+
+
+
+//------------------------------------------------------------------------------
+// delta & varint coding, remembers every body's values of the frame before
+class Trajectory_Codec{
+public:
+  Trajectory_Codec(float step);   // 0 -> lossless (float bits xor-ed instead of rounded values subtracted)
+  void encode(const trajectory_frame& frame, uint32_t frame_number, bool keyframe, std::vector< uint8_t >& data);
+  void decode(std::span< const uint8_t > data, uint32_t frame_number, bool keyframe, trajectory_frame& frame);   // 'frame.ids' sized by caller
+  
+private:
+  static constexpr std::size_t channel_count = 6;   // position x & y, rotation, velocity x & y, angular velocity
+  static constexpr body_id max_body_id = 1u << 30;   // guards against broken files
+  float step;
+  std::vector< std::array< uint64_t, channel_count > > previous;   // by body id
+  std::vector< uint32_t > seen;   // by body id, frame number + 1 it was last in, 0 -> never
+  
+  uint64_t to_code(float value);
+  float from_code(uint64_t code);
+  uint64_t delta(uint64_t code, uint64_t previous);
+  uint64_t undelta(uint64_t delta, uint64_t previous);
+  void resize(body_id id);
+  static float get_channel(const trajectory_frame& frame, std::size_t c, std::size_t i);
+  static void set_channel(trajectory_frame& frame, std::size_t c, std::size_t i, float value);
+  static void write_varint(uint64_t value, std::vector< uint8_t >& data);
+  static uint64_t read_varint(std::span< const uint8_t > data, std::size_t& pos);
+  static uint64_t zigzag(int64_t value);
+  static int64_t unzigzag(uint64_t value);
+};
+
+
+
+//------------------------------------------------------------------------------
+// records frames on its own thread, the ticks only copy the body states.
+// nothing is dropped: with every frame buffer still queued the ticks wait
+class Trajectory_Writer{
+public:
+  static constexpr char magic[8] = {'2', 'D', 'P', 'H', 'Y', 'T', 'R', 'J'};
+  static constexpr uint32_t endian_marker = 0x01020304;
+  static constexpr uint32_t version = 1;
+  
+  Trajectory_Writer(const std::string& file_name, uint interval, float step);   // throws if the file can't be opened
+  ~Trajectory_Writer();   // see 'finish()'
+  Trajectory_Writer(const Trajectory_Writer&) = delete;
+  Trajectory_Writer& operator=(const Trajectory_Writer&) = delete;
+  trajectory_frame& get_frame();   // to fill in, then 'push()'
+  void push();
+  void finish();   // writes what's still queued & the index, no more frames after it
+  bool is_ok();   // false if anything failed to write
+  uint32_t get_frame_count();
+  uint64_t get_byte_count();
+  uint64_t get_body_state_count();
+  double get_wait_time();   // seconds the ticks waited for a free frame buffer
+  
+private:
+  std::string file_name;
+  std::ofstream file;
+  trajectory_header header = {};
+  Trajectory_Codec codec;
+  uint32_t keyframe_interval = 32;
+  std::vector< trajectory_keyframe > keyframes;
+  std::vector< uint8_t > encoded;
+  uint64_t byte_count = 0;
+  uint64_t body_state_count = 0;
+  bool ok = true;
+  
+  std::vector< trajectory_frame > frames = std::vector< trajectory_frame >(4);   // in flight at most
+  std::deque< trajectory_frame* > free_frames;
+  std::deque< trajectory_frame* > queued;
+  trajectory_frame* filling = nullptr;
+  std::thread thread;
+  std::mutex mutex;
+  std::condition_variable queued_signal;
+  std::condition_variable free_signal;
+  bool stopping = false;
+  double wait_time = 0.0;
+  
+  void work();
+    void write_frame(const trajectory_frame& frame);
+  void write_index();
+};
+
+
+
+//------------------------------------------------------------------------------
+// reads a finished trajectory file, starting at any keyframe
+class Trajectory_Reader{
+public:
+  Trajectory_Reader(const std::string& file_name);   // checks header & index
+  uint get_interval();
+  bool is_quantised();
+  float get_step();
+  uint32_t get_frame_count();
+  bool read_at(uint tick, trajectory_frame& frame);   // last frame at or before 'tick', false if there is none
+  bool read(trajectory_frame& frame);   // next frame, false at the end
+  
+private:
+  Mapped_File file;
+  trajectory_header header;
+  std::vector< trajectory_keyframe > keyframes;
+  Trajectory_Codec codec;
+  std::size_t pos = 0;
+  uint32_t frame_number = 0;
+  
+  static trajectory_header read_header(Mapped_File& file);
+  trajectory_frame_header peek();   // of the next frame
+};
\ No newline at end of file